@@ -0,0 +1,102 @@
+// Andrew Naplavkov
+
+#ifndef STEP_ARENA_HPP
+#define STEP_ARENA_HPP
+
+#include "detail/utility.hpp"
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace step {
+
+/// Monotonic memory resource.
+
+/// Allocations are carved from blocks of geometrically growing size,
+/// deallocation is no-op, all the memory is released at once.
+/// @code
+/// step::arena mem;
+/// step::suffix_tree<char, size_t, my_map, step::arena_allocator<char>> tree{
+///     mem};
+/// @endcode
+class arena {
+public:
+    explicit arena(size_t block_size = 4096) : block_size_{block_size} {}
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    /// @param alignment - shall not exceed alignof(std::max_align_t).
+    void* allocate(size_t bytes, size_t alignment)
+    {
+        size_t pos = (pos_ + alignment - 1) / alignment * alignment;
+        if (blocks_.empty() || pos + bytes > capacity_) {
+            capacity_ = std::max(bytes, block_size_);
+            blocks_.emplace_back(new char[capacity_]);
+            block_size_ *= 2;
+            pos = 0;
+        }
+        pos_ = pos + bytes;
+        return blocks_.back().get() + pos;
+    }
+
+    /// Free all the blocks, the allocations become invalid
+    void release() noexcept
+    {
+        blocks_.clear();
+        pos_ = capacity_ = 0;
+    }
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t block_size_;
+    size_t pos_ = 0;
+    size_t capacity_ = 0;
+};
+
+/// Allocator that refers to the arena.
+template <class T>
+class arena_allocator {
+    template <class>
+    friend class arena_allocator;
+
+    arena* arena_;
+
+public:
+    using value_type = T;
+
+    arena_allocator(arena& mem) noexcept : arena_{&mem} {}
+
+    template <class U>
+    arena_allocator(const arena_allocator<U>& other) noexcept
+        : arena_{other.arena_}
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t));
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+            throw std::bad_array_new_length{};
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    template <class U>
+    friend bool operator==(const arena_allocator& lhs,
+                           const arena_allocator<U>& rhs)
+    {
+        return lhs.arena_ == rhs.arena_;
+    }
+
+    template <class U>
+    friend bool operator!=(const arena_allocator& lhs,
+                           const arena_allocator<U>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+};
+
+}  // namespace step
+
+#endif  // STEP_ARENA_HPP
@@ -0,0 +1,156 @@
+// Andrew Naplavkov
+
+#ifndef STEP_ANTI_DIAGONAL_HPP
+#define STEP_ANTI_DIAGONAL_HPP
+
+#include "utility.hpp"
+
+namespace step::anti_diagonal {
+
+constexpr size_t chunk_size = 64;
+
+/// Characters are copied to arrays, so the inner loop can be vectorized
+template <class RandomIt1, class RandomIt2>
+constexpr bool contiguous_v =
+    std::is_arithmetic_v<iter_value_t<RandomIt1>> &&
+    std::is_arithmetic_v<iter_value_t<RandomIt2>>;
+
+/// Cells [first, last) of the anti-diagonal from the two previous ones.
+
+/// Restrict-qualified rows and chunks of constant size let the compiler
+/// vectorize without runtime alias checks and epilogues.
+template <class Cell,
+          class RandomIt1,
+          class RandomIt2,
+          class Equal,
+          class Relax>
+void relax_cells(Cell* __restrict cur,
+                 const Cell* __restrict up,
+                 const Cell* __restrict diag,
+                 size_t first,
+                 size_t last,
+                 RandomIt1 first1,
+                 RandomIt2 rfirst2,
+                 size_t shift,
+                 const Equal& eq,
+                 Relax relax)
+{
+    for (; first + chunk_size <= last; first += chunk_size)
+        for (size_t i = 0; i < chunk_size; ++i) {
+            auto l = first + i;
+            cur[l] = Cell(relax(eq(first1[l - 1], rfirst2[shift + l]),
+                                diag[l - 1],
+                                up[l - 1],
+                                up[l]));
+        }
+    for (; first < last; ++first)
+        cur[first] = Cell(relax(eq(first1[first - 1], rfirst2[shift + first]),
+                                diag[first - 1],
+                                up[first - 1],
+                                up[first]));
+}
+
+/// @param rfirst2 - reverse iterator to the end of the second range.
+template <class Cell,
+          class RandomIt1,
+          class RandomIt2,
+          class Equal,
+          class Edge,
+          class Relax>
+void last_row_with(RandomIt1 first1,
+                   size_t size1,
+                   RandomIt2 rfirst2,
+                   size_t size2,
+                   const Equal& eq,
+                   Edge edge,
+                   Relax relax,
+                   span<size_t> result,
+                   workspace& ws)
+{
+    auto scope = workspace::scope{ws};
+    auto cells = ws.get<Cell>(3 * (size1 + 1));
+    std::fill(cells.begin(), cells.end(), 0);
+    auto tbl = [&](size_t t) { return cells.data() + t % 3 * (size1 + 1); };
+    for (size_t t = 0; t <= size1 + size2; ++t) {
+        auto cur = tbl(t);
+        auto up = tbl(t + 2);    // t - 1
+        auto diag = tbl(t + 1);  // t - 2
+        if (t <= size2)
+            cur[0] = Cell(edge(t));
+        if (t <= size1)
+            cur[t] = Cell(edge(t));
+        auto first = t > size2 ? t - size2 : 1;
+        auto last = std::min(size1 + 1, t);
+        relax_cells(cur,
+                    up,
+                    diag,
+                    first,
+                    last,
+                    first1,
+                    rfirst2,
+                    size2 - t,  // modular arithmetic
+                    eq,
+                    relax);
+        if (t >= size1)
+            result[t - size1] = cur[size1];
+    }
+}
+
+/// Last row of the dynamic programming table, computed by anti-diagonals.
+
+/// Cells of an anti-diagonal are independent, so the inner loop has
+/// no data dependency and can be vectorized. Cells are narrowed to
+/// 16 or 32 bits if the values fit.
+/// Time complexity O(N*M), space complexity O(N+M), where:
+/// N = std::distance(first1, last1), M = std::distance(first2, last2).
+/// @param edge - value of the cells (i, 0) and (0, i).
+/// @param relax - value of the cell from the match flag
+///                and the diagonal, upper and left neighbors.
+/// @param ws - the row is taken from it, the rest is given back.
+template <class RandomIt1,
+          class RandomIt2,
+          class Equal,
+          class Edge,
+          class Relax>
+span<size_t> last_row(RandomIt1 first1,
+                      RandomIt1 last1,
+                      RandomIt2 first2,
+                      RandomIt2 last2,
+                      const Equal& eq,
+                      Edge edge,
+                      Relax relax,
+                      workspace& ws)
+{
+    size_t size1 = std::distance(first1, last1);
+    size_t size2 = std::distance(first2, last2);
+    auto result = ws.get<size_t>(size2 + 1);
+    auto scope = workspace::scope{ws};
+    auto run = [&](auto first1, auto rfirst2) {
+        auto count = size1 + size2;
+        if (count < std::numeric_limits<uint16_t>::max())
+            last_row_with<uint16_t>(
+                first1, size1, rfirst2, size2, eq, edge, relax, result, ws);
+        else if (count < std::numeric_limits<uint32_t>::max())
+            last_row_with<uint32_t>(
+                first1, size1, rfirst2, size2, eq, edge, relax, result, ws);
+        else
+            last_row_with<size_t>(
+                first1, size1, rfirst2, size2, eq, edge, relax, result, ws);
+    };
+    if constexpr (contiguous_v<RandomIt1, RandomIt2>) {
+        auto str1 = ws.get<iter_value_t<RandomIt1>>(size1);
+        auto str2 = ws.get<iter_value_t<RandomIt2>>(size2);
+        std::copy(first1, last1, str1.begin());
+        std::copy(std::make_reverse_iterator(last2),
+                  std::make_reverse_iterator(first2),
+                  str2.begin());
+        run(str1.data(), str2.data());
+    }
+    else
+        run(first1, std::make_reverse_iterator(last2));
+    return result;
+}
+
+}  // namespace step::anti_diagonal
+
+#endif  // STEP_ANTI_DIAGONAL_HPP
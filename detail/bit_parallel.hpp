@@ -0,0 +1,249 @@
+// Andrew Naplavkov
+
+#ifndef STEP_BIT_PARALLEL_HPP
+#define STEP_BIT_PARALLEL_HPP
+
+#include "utility.hpp"
+#include <functional>
+
+namespace step::bit_parallel {
+
+using word_t = uint64_t;
+
+constexpr size_t word_size = std::numeric_limits<word_t>::digits;
+
+template <class T, class = std::void_t<>>
+struct is_hashable : std::false_type {
+};
+
+template <class T>
+struct is_hashable<T,
+                   std::void_t<decltype(std::hash<T>{}(std::declval<T>()))>>
+    : std::true_type {
+};
+
+template <class Equal, class T>
+constexpr bool is_equal_to_v = std::is_same_v<Equal, std::equal_to<>> ||
+                               std::is_same_v<Equal, std::equal_to<T>>;
+
+/// Characters can be grouped by std::hash and compared with operator==
+template <class Equal, class RandomIt1, class RandomIt2>
+constexpr bool enabled_v =
+    std::is_same_v<iter_value_t<RandomIt1>, iter_value_t<RandomIt2>> &&
+    is_hashable<iter_value_t<RandomIt1>>::value &&
+    is_equal_to_v<std::decay_t<Equal>, iter_value_t<RandomIt1>>;
+
+/// Bit masks of the pattern positions where each character occurs.
+
+/// Masks are stored for small alphabets, otherwise they are made
+/// on request from the lists of positions. Characters are found by open
+/// addressing on the positions of their first occurrences, so the table
+/// takes all its memory from the workspace.
+template <class RandomIt>
+class match_table {
+    using value_t = iter_value_t<RandomIt>;
+
+public:
+    match_table(RandomIt first, RandomIt last, workspace& ws) : first_{first}
+    {
+        size_t size = std::distance(first, last);
+        blocks_ = (size + word_size - 1) / word_size;
+        size_t bits = 1;
+        while ((size_t{1} << bits) < 2 * size)
+            ++bits;
+        shift_ = std::numeric_limits<uint64_t>::digits - bits;
+        slots_ = ws.get<size_t>(size_t{1} << bits);
+        std::fill(slots_.begin(), slots_.end(), npos);
+        firsts_ = ws.get<size_t>(size);
+        auto rows = ws.get<size_t>(size);
+        for (size_t i = 0; i < size; ++i) {
+            auto& row = slot(first[i]);
+            if (row == npos)
+                firsts_[row = rows_++] = i;
+            rows[i] = row;
+        }
+        buf_ = ws.get<word_t>(blocks_);
+        if (rows_ <= dense_limit) {
+            masks_ = ws.get<word_t>(rows_ * blocks_);
+            std::fill(masks_.begin(), masks_.end(), 0);
+            for (size_t i = 0; i < size; ++i)
+                masks_[rows[i] * blocks_ + i / word_size] |= bit(i);
+            return;
+        }
+        offsets_ = ws.get<size_t>(rows_ + 1);
+        std::fill(offsets_.begin(), offsets_.end(), 0);
+        for (auto row : rows)
+            ++offsets_[row + 1];
+        std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+        positions_ = ws.get<size_t>(size);
+        auto next = ws.get<size_t>(rows_);
+        std::copy(offsets_.begin(), offsets_.end() - 1, next.begin());
+        for (size_t i = 0; i < size; ++i)
+            positions_[next[rows[i]]++] = i;
+    }
+
+    size_t blocks() const { return blocks_; }
+
+    /// Return nullptr if the character is not in the pattern
+    const word_t* find(const value_t& val)
+    {
+        size_t row = slot(val);
+        if (row == npos)
+            return nullptr;
+        if (rows_ <= dense_limit)
+            return masks_.data() + row * blocks_;
+        std::fill(buf_.begin(), buf_.end(), 0);
+        for (auto i = offsets_[row]; i < offsets_[row + 1]; ++i)
+            buf_[positions_[i] / word_size] |= bit(positions_[i]);
+        return buf_.data();
+    }
+
+private:
+    static constexpr size_t dense_limit = 256;
+    static constexpr size_t npos = -1;
+
+    RandomIt first_;
+    size_t blocks_;
+    size_t rows_ = 0;
+    size_t shift_;
+    span<size_t> slots_;   // rows by hash
+    span<size_t> firsts_;  // first positions by row
+    span<word_t> masks_;   // rows of blocks
+    span<size_t> offsets_;
+    span<size_t> positions_;
+    span<word_t> buf_;
+
+    static word_t bit(size_t pos) { return word_t{1} << pos % word_size; }
+
+    /// Fibonacci hashing spreads clustered hashes, linear probing follows
+    size_t& slot(const value_t& val)
+    {
+        uint64_t hash = std::hash<value_t>{}(val);
+        auto mask = slots_.size() - 1;
+        for (size_t i = (hash * 0x9e3779b97f4a7c15ull) >> shift_;;
+             i = (i + 1) & mask) {
+            auto& row = slots_[i];
+            if (row == npos || first_[firsts_[row]] == val)
+                return row;
+        }
+    }
+};
+
+/// Step of Myers' algorithm over a block of the column.
+
+/// @param hin, hout - differences of the score along the upper and
+///                    the lower borders of the block.
+/// @param high - bit of the last row of the block.
+/// @see https://doi.org/10.1145/316542.316550
+inline int advance_levenshtein(
+    word_t& pv, word_t& mv, word_t eq, int hin, word_t high)
+{
+    word_t xv = eq | mv;
+    if (hin < 0)
+        eq |= 1;
+    word_t xh = (((eq & pv) + pv) ^ pv) | eq;
+    word_t ph = mv | ~(xh | pv);
+    word_t mh = pv & xh;
+    int hout = (ph & high) ? 1 : (mh & high) ? -1 : 0;
+    ph <<= 1;
+    mh <<= 1;
+    if (hin < 0)
+        mh |= 1;
+    else if (hin > 0)
+        ph |= 1;
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    return hout;
+}
+
+/// Last row of the Levenshtein distance table, 64 cells per operation.
+
+/// The first range is the pattern along the column,
+/// the second one is the text along the row.
+/// Hyyro's multi-word version of Myers' algorithm.
+/// Time complexity O(N*M/W), space complexity O(N/W+M), where:
+/// N = std::distance(first1, last1), M = std::distance(first2, last2),
+/// W - number of bits in the word.
+/// @param ws - the row is taken from it, the rest is given back.
+template <class RandomIt1, class RandomIt2>
+span<size_t> levenshtein_last_row(RandomIt1 first1,
+                                  RandomIt1 last1,
+                                  RandomIt2 first2,
+                                  RandomIt2 last2,
+                                  workspace& ws)
+{
+    size_t size1 = std::distance(first1, last1);
+    size_t size2 = std::distance(first2, last2);
+    auto result = ws.get<size_t>(size2 + 1);
+    std::iota(result.begin(), result.end(), size1);
+    if (!size1)
+        return result;
+    auto scope = workspace::scope{ws};
+    auto tbl = match_table<RandomIt1>(first1, last1, ws);
+    auto blocks = tbl.blocks();
+    auto pv = ws.get<word_t>(blocks);
+    auto mv = ws.get<word_t>(blocks);
+    std::fill(pv.begin(), pv.end(), ~word_t{});
+    std::fill(mv.begin(), mv.end(), 0);
+    auto last = blocks - 1;
+    auto high = word_t{1} << (size1 - 1) % word_size;
+    auto top = word_t{1} << (word_size - 1);
+    for (size_t r = 0; r < size2; ++r) {
+        auto eq = tbl.find(first2[r]);
+        int h = 1;  // the first row is 0, 1, 2...
+        for (size_t b = 0; b < blocks; ++b)
+            h = advance_levenshtein(
+                pv[b], mv[b], eq ? eq[b] : 0, h, b == last ? high : top);
+        result[r + 1] = result[r] + h;
+    }
+    return result;
+}
+
+/// Last row of the longest common subsequence table, 64 cells per operation.
+
+/// The first range is the pattern along the column,
+/// the second one is the text along the row.
+/// Zero bits of the vector mark the pattern positions where the length
+/// grows, the carry out of the pattern adds one to the length.
+/// Time complexity O(N*M/W), space complexity O(N/W+M), where:
+/// N = std::distance(first1, last1), M = std::distance(first2, last2),
+/// W - number of bits in the word.
+/// @see https://doi.org/10.1007/978-3-540-27801-6_11
+/// @param ws - the row is taken from it, the rest is given back.
+template <class RandomIt1, class RandomIt2>
+span<size_t> lcs_last_row(RandomIt1 first1,
+                          RandomIt1 last1,
+                          RandomIt2 first2,
+                          RandomIt2 last2,
+                          workspace& ws)
+{
+    size_t size1 = std::distance(first1, last1);
+    size_t size2 = std::distance(first2, last2);
+    auto result = ws.get<size_t>(size2 + 1);
+    std::fill(result.begin(), result.end(), 0);
+    if (!size1)
+        return result;
+    auto scope = workspace::scope{ws};
+    auto tbl = match_table<RandomIt1>(first1, last1, ws);
+    auto blocks = tbl.blocks();
+    auto v = ws.get<word_t>(blocks);
+    std::fill(v.begin(), v.end(), ~word_t{});  // ones after the pattern
+    for (size_t r = 0; r < size2; ++r) {
+        word_t carry = 0;
+        if (auto eq = tbl.find(first2[r]))
+            for (size_t b = 0; b < blocks; ++b) {
+                word_t u = v[b] & eq[b];
+                word_t sum = v[b] + carry;
+                carry = sum < carry;
+                sum += u;
+                carry |= sum < u;
+                v[b] = sum | (v[b] - u);
+            }
+        result[r + 1] = result[r] + carry;
+    }
+    return result;
+}
+
+}  // namespace step::bit_parallel
+
+#endif  // STEP_BIT_PARALLEL_HPP
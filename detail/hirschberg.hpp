@@ -3,7 +3,12 @@
 #ifndef STEP_HIRSCHBERG_HPP
 #define STEP_HIRSCHBERG_HPP
 
+#include "../longest_increasing_subsequence.hpp"
 #include "utility.hpp"
+#include <functional>
+#include <future>
+#include <tuple>
+#include <unordered_map>
 
 namespace step::hirschberg {
 
@@ -13,22 +18,96 @@ auto partition_point(RandomIt1 first1,
                      RandomIt2 first2,
                      RandomIt2 last2,
                      const DynamicProg& dp,
-                     BinaryOp op)
+                     BinaryOp op,
+                     workspace& ws,
+                     size_t threads = 1)
 {
     auto split1 = first1 + std::distance(first1, last1) / 2;
-    auto top = dp.make_last_row(first1, split1, first2, last2);
-    auto bottom = dp.make_last_row(std::make_reverse_iterator(last1),
-                                   std::make_reverse_iterator(split1),
-                                   std::make_reverse_iterator(last2),
-                                   std::make_reverse_iterator(first2));
-    std::transform(
-        top.begin(), top.end(), bottom.rbegin(), top.begin(), std::plus{});
+    auto scope = workspace::scope{ws};
+    auto other = workspace{};  // for the concurrent pass
+    auto make_bottom = [&] {
+        return dp.make_last_row(std::make_reverse_iterator(last1),
+                                std::make_reverse_iterator(split1),
+                                std::make_reverse_iterator(last2),
+                                std::make_reverse_iterator(first2),
+                                threads > 1 ? other : ws);
+    };
+    auto task = std::future<decltype(make_bottom())>{};
+    if (threads > 1)
+        task = std::async(std::launch::async, make_bottom);
+    auto top = dp.make_last_row(first1, split1, first2, last2, ws);
+    auto bottom = task.valid() ? task.get() : make_bottom();
+    std::transform(top.begin(),
+                   top.end(),
+                   std::make_reverse_iterator(bottom.end()),
+                   top.begin(),
+                   std::plus{});
     auto split2 =
         first2 + std::distance(top.begin(),
                                std::min_element(top.begin(), top.end(), dp));
     return op(split1, split2);
 }
 
+/// Split the longer range in half and find the matching split of the other.
+template <class RandomIt1, class RandomIt2, class DynamicProg>
+std::pair<RandomIt1, RandomIt2> split(RandomIt1 first1,
+                                      RandomIt1 last1,
+                                      RandomIt2 first2,
+                                      RandomIt2 last2,
+                                      const DynamicProg& dp,
+                                      workspace& ws,
+                                      size_t threads = 1)
+{
+    return std::distance(first2, last2) < std::distance(first1, last1)
+               ? hirschberg::partition_point(first1,
+                                             last1,
+                                             first2,
+                                             last2,
+                                             dp,
+                                             make_pair{},
+                                             ws,
+                                             threads)
+               : hirschberg::partition_point(first2,
+                                             last2,
+                                             first1,
+                                             last1,
+                                             dp,
+                                             make_reverse_pair{},
+                                             ws,
+                                             threads);
+}
+
+/// Common prefix and suffix are cut off, they are matched right away.
+
+/// @return the differing core as {first1, last1, first2, last2}.
+template <class RandomIt1, class RandomIt2, class Equal>
+auto trim(RandomIt1 first1,
+          RandomIt1 last1,
+          RandomIt2 first2,
+          RandomIt2 last2,
+          const Equal& eq)
+{
+    auto head = std::mismatch(first1, last1, first2, last2, eq);
+    auto tail = std::mismatch(std::make_reverse_iterator(last1),
+                              std::make_reverse_iterator(head.first),
+                              std::make_reverse_iterator(last2),
+                              std::make_reverse_iterator(head.second),
+                              eq);
+    return std::tuple{
+        head.first, tail.first.base(), head.second, tail.second.base()};
+}
+
+template <class RandomIt1, class RandomIt2>
+bool trivial(RandomIt1 first1,
+             RandomIt1 last1,
+             RandomIt2 first2,
+             RandomIt2 last2)
+{
+    return std::distance(first1, last1) < 2 || std::distance(first2, last2) < 2;
+}
+
+/// Only the differing core is divided by dynamic programming.
+/// @param ws - to reuse the rows between the passes.
 /// @see https://en.wikipedia.org/wiki/Hirschberg's_algorithm
 template <class RandomIt1, class RandomIt2, class OutputIt, class DynamicProg>
 OutputIt trace(RandomIt1 first1,
@@ -36,25 +115,218 @@ OutputIt trace(RandomIt1 first1,
                RandomIt2 first2,
                RandomIt2 last2,
                OutputIt result,
-               const DynamicProg& dp)
-{
-    auto size1 = std::distance(first1, last1);
-    auto size2 = std::distance(first2, last2);
-    if (size1 < 2 || size2 < 2)
-        return dp.trivial_trace(first1, last1, first2, last2, result);
-
-    auto [split1, split2] =
-        size2 < size1
-            ? hirschberg::partition_point(
-                  first1, last1, first2, last2, dp, make_pair{})
-            : hirschberg::partition_point(
-                  first2, last2, first1, last1, dp, make_reverse_pair{});
-
-    result = hirschberg::trace(first1, split1, first2, split2, result, dp);
-    result = hirschberg::trace(split1, last1, split2, last2, result, dp);
+               const DynamicProg& dp,
+               workspace& ws)
+{
+    auto [core1, end1, core2, end2] =
+        hirschberg::trim(first1, last1, first2, last2, dp.eq);
+    result = dp.matched_trace(first1, core1, first2, result);
+    if (hirschberg::trivial(core1, end1, core2, end2))
+        result = dp.trivial_trace(core1, end1, core2, end2, result);
+    else {
+        auto [mid1, mid2] = hirschberg::split(core1, end1, core2, end2, dp, ws);
+        result = hirschberg::trace(core1, mid1, core2, mid2, result, dp, ws);
+        result = hirschberg::trace(mid1, end1, mid2, end2, result, dp, ws);
+    }
+    return dp.matched_trace(end1, last1, end2, result);
+}
+
+/// Ranges of the trace, that are output by matched_trace or trivial_trace.
+template <class RandomIt1, class RandomIt2>
+struct leaf {
+    RandomIt1 first1;
+    RandomIt1 last1;
+    RandomIt2 first2;
+    RandomIt2 last2;
+    bool matched;
+};
+
+/// Policy that records the leaves of the trace instead of the output.
+template <class DynamicProg>
+struct recorder {
+    const DynamicProg& dp;
+    decltype(dp.eq) eq;
+
+    template <class RandomIt1, class RandomIt2>
+    auto make_last_row(RandomIt1 first1,
+                       RandomIt1 last1,
+                       RandomIt2 first2,
+                       RandomIt2 last2,
+                       workspace& ws) const
+    {
+        return dp.make_last_row(first1, last1, first2, last2, ws);
+    }
+
+    bool operator()(size_t lhs, size_t rhs) const { return dp(lhs, rhs); }
+
+    template <class RandomIt1, class RandomIt2, class OutputIt>
+    OutputIt trivial_trace(RandomIt1 first1,
+                           RandomIt1 last1,
+                           RandomIt2 first2,
+                           RandomIt2 last2,
+                           OutputIt result) const
+    {
+        if (first1 != last1 || first2 != last2)
+            *result++ = leaf<RandomIt1, RandomIt2>{
+                first1, last1, first2, last2, false};
+        return result;
+    }
+
+    template <class RandomIt1, class RandomIt2, class OutputIt>
+    OutputIt matched_trace(RandomIt1 first1,
+                           RandomIt1 last1,
+                           RandomIt2 first2,
+                           OutputIt result) const
+    {
+        if (first1 != last1)
+            *result++ = leaf<RandomIt1, RandomIt2>{
+                first1, last1, first2, first2 + (last1 - first1), true};
+        return result;
+    }
+};
+
+template <class RandomIt1, class RandomIt2, class DynamicProg>
+void divide(RandomIt1 first1,
+            RandomIt1 last1,
+            RandomIt2 first2,
+            RandomIt2 last2,
+            const recorder<DynamicProg>& rec,
+            size_t threads,
+            std::vector<leaf<RandomIt1, RandomIt2>>& leaves)
+{
+    auto result = std::back_inserter(leaves);
+    auto ws = workspace{};
+    if (threads < 2) {
+        hirschberg::trace(first1, last1, first2, last2, result, rec, ws);
+        return;
+    }
+    RandomIt1 core1, end1, mid1;
+    RandomIt2 core2, end2, mid2;
+    std::tie(core1, end1, core2, end2) =
+        hirschberg::trim(first1, last1, first2, last2, rec.eq);
+    rec.matched_trace(first1, core1, first2, result);
+    if (hirschberg::trivial(core1, end1, core2, end2))
+        rec.trivial_trace(core1, end1, core2, end2, result);
+    else {
+        std::tie(mid1, mid2) =
+            hirschberg::split(core1, end1, core2, end2, rec, ws, threads);
+        std::vector<leaf<RandomIt1, RandomIt2>> tail;
+        auto task = std::async(std::launch::async, [&] {
+            hirschberg::divide(
+                mid1, end1, mid2, end2, rec, threads - threads / 2, tail);
+        });
+        hirschberg::divide(core1, mid1, core2, mid2, rec, threads / 2, leaves);
+        task.get();
+        leaves.insert(leaves.end(), tail.begin(), tail.end());
+    }
+    rec.matched_trace(end1, last1, end2, result);
+}
+
+/// Parallel version, the two passes of the dynamic programming
+/// and the two halves of the trace are forked as tasks.
+
+/// The leaves of the trace are collected first, so the output is done
+/// sequentially and in order.
+/// Space complexity O(N+M), where:
+/// N = std::distance(first1, last1), M = std::distance(first2, last2).
+/// @param threads - to split the recursion between.
+template <class RandomIt1, class RandomIt2, class OutputIt, class DynamicProg>
+OutputIt trace(RandomIt1 first1,
+               RandomIt1 last1,
+               RandomIt2 first2,
+               RandomIt2 last2,
+               OutputIt result,
+               const DynamicProg& dp,
+               size_t threads)
+{
+    if (threads < 2) {
+        auto ws = workspace{};
+        return hirschberg::trace(first1, last1, first2, last2, result, dp, ws);
+    }
+    std::vector<leaf<RandomIt1, RandomIt2>> leaves;
+    hirschberg::divide(first1,
+                       last1,
+                       first2,
+                       last2,
+                       recorder<DynamicProg>{dp, dp.eq},
+                       threads,
+                       leaves);
+    for (auto& item : leaves)
+        result = item.matched
+                     ? dp.matched_trace(
+                           item.first1, item.last1, item.first2, result)
+                     : dp.trivial_trace(item.first1,
+                                        item.last1,
+                                        item.first2,
+                                        item.last2,
+                                        result);
     return result;
 }
 
+/// Split the ranges on the elements that occur once in each of them,
+/// then trace the gaps between these anchors.
+
+/// The longest increasing sequence of anchors is taken, as in patience diff.
+/// The result is not optimal in general, but large inputs are divided
+/// in linear time. Elements are grouped by std::hash,
+/// so the predicate shall agree with operator==.
+template <class RandomIt1, class RandomIt2, class OutputIt, class DynamicProg>
+OutputIt anchored_trace(RandomIt1 first1,
+                        RandomIt1 last1,
+                        RandomIt2 first2,
+                        RandomIt2 last2,
+                        OutputIt result,
+                        const DynamicProg& dp)
+{
+    using value_t = iter_value_t<RandomIt1>;
+    struct counter {
+        size_t count1, pos1, count2, pos2;
+    };
+    auto hash = [](const value_t& val) { return std::hash<value_t>{}(val); };
+    std::unordered_map<std::reference_wrapper<const value_t>,
+                       counter,
+                       decltype(hash),
+                       std::equal_to<value_t>>
+        counters(0, hash);
+    for (auto it = first1; it != last1; ++it) {
+        auto& item = counters.try_emplace(std::cref(*it)).first->second;
+        item.count1 += 1;
+        item.pos1 = it - first1;
+    }
+    for (auto it = first2; it != last2; ++it)
+        if (auto pos = counters.find(std::cref(*it)); pos != counters.end()) {
+            pos->second.count2 += 1;
+            pos->second.pos2 = it - first2;
+        }
+    std::vector<std::pair<size_t, size_t>> anchors;
+    for (auto& [key, item] : counters)
+        if (item.count1 == 1 && item.count2 == 1)
+            anchors.emplace_back(item.pos1, item.pos2);
+    std::sort(anchors.begin(), anchors.end());
+    auto increasing = longest_increasing_subsequence::partition(
+        anchors.begin(), anchors.end(), [](auto& lhs, auto& rhs) {
+            return lhs.second < rhs.second;
+        });
+    anchors.erase(increasing, anchors.end());
+    auto ws = workspace{};
+    size_t prev1 = 0, prev2 = 0;
+    for (auto [pos1, pos2] : anchors) {
+        result = hirschberg::trace(first1 + prev1,
+                                   first1 + pos1,
+                                   first2 + prev2,
+                                   first2 + pos2,
+                                   result,
+                                   dp,
+                                   ws);
+        prev1 = pos1 + 1;
+        prev2 = pos2 + 1;
+        result = dp.matched_trace(
+            first1 + pos1, first1 + prev1, first2 + pos2, result);
+    }
+    return hirschberg::trace(
+        first1 + prev1, last1, first2 + prev2, last2, result, dp, ws);
+}
+
 }  // namespace step::hirschberg
 
 #endif  // STEP_HIRSCHBERG_HPP
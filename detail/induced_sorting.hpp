@@ -0,0 +1,114 @@
+// Andrew Naplavkov
+
+#ifndef STEP_INDUCED_SORTING_HPP
+#define STEP_INDUCED_SORTING_HPP
+
+#include "utility.hpp"
+
+namespace step {
+
+/// Nong-Zhang-Chan SA-IS algorithm for constructing suffix array.
+
+/// Time complexity O(N) for byte and 16-bit alphabets, space complexity O(N),
+/// where: N - text length.
+/// @see https://doi.org/10.1109/DCC.2009.42
+struct induced_sorting {
+    template <class T, class Size, class Compare>
+    void operator()(const std::vector<T>& str,
+                    std::vector<Size>& idx,
+                    const Compare& cmp) const
+    {
+        auto ranks = dense_ranks<Size>(str, cmp);
+        auto upper = ranks.empty()
+                         ? Size{}
+                         : *std::max_element(ranks.begin(), ranks.end());
+        sort(ranks, upper, idx);
+    }
+
+private:
+    /// @param str - characters in [0, upper]
+    template <class Size>
+    static void sort(const std::vector<Size>& str,
+                     Size upper,
+                     std::vector<Size>& sa)
+    {
+        const Size n = (Size)str.size();
+        const Size npos = flip(Size{});
+        if (n < 2) {
+            std::fill(sa.begin(), sa.end(), Size{});
+            return;
+        }
+
+        std::vector<bool> stype(n);
+        for (Size i = n - 1; i-- > 0;)
+            stype[i] =
+                str[i] == str[i + 1] ? stype[i + 1] : str[i] < str[i + 1];
+        auto lms = [&](Size i) { return i && stype[i] && !stype[i - 1]; };
+
+        // bucket heads of L-type and S-type suffixes
+        std::vector<Size> heads_l(size_t{upper} + 1), heads_s(heads_l.size());
+        for (Size i = 0; i < n; ++i)
+            stype[i] ? ++heads_l[str[i] + 1] : ++heads_s[str[i]];
+        for (Size c = 0; c <= upper; ++c) {
+            heads_s[c] += heads_l[c];
+            if (c < upper)
+                heads_l[c + 1] += heads_s[c];
+        }
+
+        auto induce = [&](const std::vector<Size>& seeds) {
+            std::fill(sa.begin(), sa.end(), npos);
+            auto buf = heads_s;
+            for (Size pos : seeds)
+                sa[buf[str[pos]]++] = pos;
+            buf = heads_l;
+            sa[buf[str[n - 1]]++] = n - 1;
+            for (Size i = 0; i < n; ++i)
+                if (Size pos = sa[i]; pos != npos && pos && !stype[pos - 1])
+                    sa[buf[str[pos - 1]]++] = pos - 1;
+            buf = heads_l;
+            for (Size i = n; i-- > 0;)
+                if (Size pos = sa[i]; pos != npos && pos && stype[pos - 1])
+                    sa[--buf[str[pos - 1] + 1]] = pos - 1;
+        };
+
+        std::vector<Size> seeds, order(n, npos);
+        for (Size i = 1; i < n; ++i)
+            if (lms(i)) {
+                order[i] = (Size)seeds.size();
+                seeds.push_back(i);
+            }
+        induce(seeds);
+        if (seeds.empty())
+            return;
+
+        // name LMS substrings and sort them recursively
+        const Size m = (Size)seeds.size();
+        std::vector<Size> sorted;
+        sorted.reserve(m);
+        for (Size pos : sa)
+            if (order[pos] != npos)
+                sorted.push_back(pos);
+        std::vector<Size> names(m), rec(m);
+        Size name = 0;
+        for (Size i = 1; i < m; ++i) {
+            Size l = sorted[i - 1], r = sorted[i];
+            Size last_l = order[l] + 1 < m ? seeds[order[l] + 1] : n;
+            Size last_r = order[r] + 1 < m ? seeds[order[r] + 1] : n;
+            bool same = last_l - l == last_r - r;
+            if (same) {
+                while (l < last_l && str[l] == str[r])
+                    ++l, ++r;
+                same = l < n && r < n && str[l] == str[r];
+            }
+            names[order[sorted[i]]] = name += !same;
+        }
+        sort(names, name, rec);
+        for (Size i = 0; i < m; ++i)
+            sorted[i] = seeds[rec[i]];
+        induce(sorted);
+    }
+};
+
+}  // namespace step
+
+#endif  // STEP_INDUCED_SORTING_HPP
@@ -0,0 +1,138 @@
+// Andrew Naplavkov
+
+#ifndef STEP_MAPPED_FILE_HPP
+#define STEP_MAPPED_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <ostream>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace step {
+
+/// Read-only memory mapping of a whole file.
+class mapped_file {
+public:
+    explicit mapped_file(const char* path)
+    {
+#ifdef _WIN32
+        auto file = CreateFileA(path,
+                                GENERIC_READ,
+                                FILE_SHARE_READ,
+                                nullptr,
+                                OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL,
+                                nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw_last_error();
+        LARGE_INTEGER size;
+        auto map = GetFileSizeEx(file, &size)
+                       ? CreateFileMappingA(
+                             file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+                       : nullptr;
+        if (map) {
+            size_ = (size_t)size.QuadPart;
+            data_ = (const char*)MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+        }
+        auto err = GetLastError();
+        if (map)
+            CloseHandle(map);
+        CloseHandle(file);
+        if (!data_)
+            throw std::system_error((int)err, std::system_category());
+#else
+        int fd = ::open(path, O_RDONLY);
+        if (fd == -1)
+            throw_last_error();
+        struct stat st;
+        void* addr = MAP_FAILED;
+        if (::fstat(fd, &st) != -1 && st.st_size > 0)
+            addr = ::mmap(
+                nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        int err = st.st_size > 0 ? errno : EINVAL;
+        ::close(fd);
+        if (addr == MAP_FAILED)
+            throw std::system_error(err, std::system_category());
+        data_ = (const char*)addr;
+        size_ = (size_t)st.st_size;
+#endif
+    }
+
+    mapped_file(mapped_file&& other) noexcept
+        : data_{std::exchange(other.data_, nullptr)}
+        , size_{std::exchange(other.size_, 0)}
+    {
+    }
+
+    mapped_file& operator=(mapped_file&& other) noexcept
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    ~mapped_file()
+    {
+        if (!data_)
+            return;
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+#else
+        ::munmap((void*)data_, size_);
+#endif
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+
+    [[noreturn]] static void throw_last_error()
+    {
+#ifdef _WIN32
+        throw std::system_error((int)GetLastError(), std::system_category());
+#else
+        throw std::system_error(errno, std::system_category());
+#endif
+    }
+};
+
+namespace detail {
+
+constexpr size_t align(size_t bytes)
+{
+    return (bytes + 7) / 8 * 8;
+}
+
+/// Write 8-byte aligned section
+template <class T>
+void write(std::ostream& os, const T* data, size_t count)
+{
+    static const char padding[8] = {};
+    auto bytes = count * sizeof(T);
+    os.write((const char*)data, bytes);
+    os.write(padding, align(bytes) - bytes);
+}
+
+}  // namespace detail
+}  // namespace step
+
+#endif  // STEP_MAPPED_FILE_HPP
@@ -0,0 +1,120 @@
+// Andrew Naplavkov
+
+#ifndef STEP_MYERS_HPP
+#define STEP_MYERS_HPP
+
+#include "utility.hpp"
+
+namespace step::myers {
+
+/// Point of an optimal edit path where the forward and the reverse
+/// furthest reaching D-paths meet.
+
+/// Ranges shall not be empty.
+/// Time complexity O((N+M)*D), space complexity O(N+M), where:
+/// N = std::distance(first1, last1), M = std::distance(first2, last2),
+/// D - number of insertions and deletions.
+template <class RandomIt1, class RandomIt2, class Equal>
+auto bisect(RandomIt1 first1,
+            RandomIt1 last1,
+            RandomIt2 first2,
+            RandomIt2 last2,
+            const Equal& eq)
+{
+    using diff_t = std::ptrdiff_t;
+    using point_t = std::pair<diff_t, diff_t>;
+    diff_t size1 = std::distance(first1, last1);
+    diff_t size2 = std::distance(first2, last2);
+    diff_t max_d = (size1 + size2 + 1) / 2;
+    diff_t offset = max_d + 1;
+    diff_t delta = size1 - size2;
+    bool front = delta % 2;
+    auto fwd = std::vector<diff_t>(2 * offset + 1, -1);  // x by diagonal k
+    auto rev = fwd;  // x from the end by diagonal k
+    fwd[offset + 1] = rev[offset + 1] = 0;
+    auto valid = [&](diff_t i) { return i >= 0 && i < diff_t(fwd.size()); };
+    diff_t k1_start = 0, k1_end = 0, k2_start = 0, k2_end = 0;
+    for (diff_t d = 0; d < max_d; ++d) {
+        for (auto k1 = k1_start - d; k1 <= d - k1_end; k1 += 2) {
+            auto i1 = offset + k1;
+            auto x1 = (k1 == -d || (k1 != d && fwd[i1 - 1] < fwd[i1 + 1]))
+                          ? fwd[i1 + 1]
+                          : fwd[i1 - 1] + 1;
+            auto y1 = x1 - k1;
+            while (x1 < size1 && y1 < size2 && eq(first1[x1], first2[y1]))
+                ++x1, ++y1;
+            fwd[i1] = x1;
+            if (x1 > size1)
+                k1_end += 2;  // ran off the right
+            else if (y1 > size2)
+                k1_start += 2;  // ran off the bottom
+            else if (front) {
+                auto i2 = offset + delta - k1;
+                if (valid(i2) && rev[i2] != -1 && x1 >= size1 - rev[i2])
+                    return point_t{x1, y1};
+            }
+        }
+        for (auto k2 = k2_start - d; k2 <= d - k2_end; k2 += 2) {
+            auto i2 = offset + k2;
+            auto x2 = (k2 == -d || (k2 != d && rev[i2 - 1] < rev[i2 + 1]))
+                          ? rev[i2 + 1]
+                          : rev[i2 - 1] + 1;
+            auto y2 = x2 - k2;
+            while (x2 < size1 && y2 < size2 &&
+                   eq(first1[size1 - x2 - 1], first2[size2 - y2 - 1]))
+                ++x2, ++y2;
+            rev[i2] = x2;
+            if (x2 > size1)
+                k2_end += 2;  // ran off the left
+            else if (y2 > size2)
+                k2_start += 2;  // ran off the top
+            else if (!front) {
+                auto i1 = offset + delta - k2;
+                if (valid(i1) && fwd[i1] != -1 && fwd[i1] >= size1 - x2)
+                    return point_t{fwd[i1], fwd[i1] - (delta - k2)};
+            }
+        }
+    }
+    return point_t{size1, 0};  // unreachable for an optimal path
+}
+
+/// Output the elements of the first range that make up an optimal path.
+
+/// Common prefixes and suffixes are matched directly, the rest is
+/// divided at the middle of the path.
+/// Time complexity O((N+M)*D), space complexity O(N+M), where:
+/// N = std::distance(first1, last1), M = std::distance(first2, last2),
+/// D - number of insertions and deletions.
+/// @see https://doi.org/10.1007/BF01840446
+template <class RandomIt1, class RandomIt2, class OutputIt, class Equal>
+OutputIt trace(RandomIt1 first1,
+               RandomIt1 last1,
+               RandomIt2 first2,
+               RandomIt2 last2,
+               OutputIt result,
+               const Equal& eq)
+{
+    auto prefix = std::mismatch(first1, last1, first2, last2, eq);
+    result = std::copy(first1, prefix.first, result);
+    first1 = prefix.first;
+    first2 = prefix.second;
+    auto suffix = std::mismatch(std::make_reverse_iterator(last1),
+                                std::make_reverse_iterator(first1),
+                                std::make_reverse_iterator(last2),
+                                std::make_reverse_iterator(first2),
+                                eq);
+    auto split1 = suffix.first.base();
+    auto split2 = suffix.second.base();
+    if (first1 != split1 && first2 != split2) {
+        auto [x, y] = bisect(first1, split1, first2, split2, eq);
+        result =
+            myers::trace(first1, first1 + x, first2, first2 + y, result, eq);
+        result =
+            myers::trace(first1 + x, split1, first2 + y, split2, result, eq);
+    }
+    return std::copy(split1, last1, result);
+}
+
+}  // namespace step::myers
+
+#endif  // STEP_MYERS_HPP
@@ -0,0 +1,81 @@
+// Andrew Naplavkov
+
+#ifndef STEP_PARALLEL_HPP
+#define STEP_PARALLEL_HPP
+
+#include "utility.hpp"
+#include <future>
+
+namespace step::parallel {
+
+/// Split [0, count) into contiguous chunks and process them concurrently.
+
+/// @param fn - is called as fn(chunk, first, last) for each chunk.
+template <class Function>
+void for_each_chunk(size_t threads, size_t count, Function fn)
+{
+    threads = std::max<size_t>(1, std::min(threads, count));
+    std::vector<std::future<void>> tasks;
+    for (size_t i = 1; i < threads; ++i)
+        tasks.push_back(std::async(std::launch::async,
+                                   fn,
+                                   i,
+                                   count * i / threads,
+                                   count * (i + 1) / threads));
+    fn(size_t{}, size_t{}, count / threads);
+    for (auto& task : tasks)
+        task.get();
+}
+
+template <class RandomIt1, class RandomIt2, class OutputIt, class Compare>
+void merge(RandomIt1 first1,
+           RandomIt1 last1,
+           RandomIt2 first2,
+           RandomIt2 last2,
+           OutputIt result,
+           Compare cmp,
+           size_t threads)
+{
+    if (threads < 2 || first1 == last1 || first2 == last2) {
+        std::merge(first1, last1, first2, last2, result, cmp);
+        return;
+    }
+    auto mid1 = first1 + std::distance(first1, last1) / 2;
+    auto mid2 = std::lower_bound(first2, last2, *mid1, cmp);
+    auto mid = result + std::distance(first1, mid1) +
+               std::distance(first2, mid2);
+    auto task = std::async(std::launch::async, [&] {
+        parallel::merge(first1, mid1, first2, mid2, result, cmp, threads / 2);
+    });
+    parallel::merge(
+        mid1, last1, mid2, last2, mid, cmp, threads - threads / 2);
+    task.get();
+}
+
+/// Merge sort of independently sorted chunks.
+
+/// Not stable, space complexity O(N) if threads > 1.
+template <class RandomIt, class Compare>
+void sort(RandomIt first, RandomIt last, Compare cmp, size_t threads)
+{
+    if (threads < 2) {
+        std::sort(first, last, cmp);
+        return;
+    }
+    auto mid = first + std::distance(first, last) / 2;
+    auto task = std::async(std::launch::async, [&] {
+        parallel::sort(first, mid, cmp, threads / 2);
+    });
+    parallel::sort(mid, last, cmp, threads - threads / 2);
+    task.get();
+    std::vector<iter_value_t<RandomIt>> buf(std::distance(first, last));
+    parallel::merge(first, mid, mid, last, buf.begin(), cmp, threads);
+    parallel::for_each_chunk(
+        threads, buf.size(), [&](size_t, size_t from, size_t to) {
+            std::move(buf.begin() + from, buf.begin() + to, first + from);
+        });
+}
+
+}  // namespace step::parallel
+
+#endif  // STEP_PARALLEL_HPP
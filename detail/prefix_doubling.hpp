@@ -0,0 +1,178 @@
+// Andrew Naplavkov
+
+#ifndef STEP_PREFIX_DOUBLING_HPP
+#define STEP_PREFIX_DOUBLING_HPP
+
+#include "parallel.hpp"
+
+namespace step {
+
+/// Manber's algorithm for constructing suffix array.
+
+/// Time complexity O(N*log(N)*log(N)), space complexity O(N), where:
+/// N - text length.
+/// Sorting and ranking of every round are split between threads.
+struct prefix_doubling {
+    size_t threads = 1;
+
+    template <class T, class Size, class Compare>
+    void operator()(const std::vector<T>& str,
+                    std::vector<Size>& idx,
+                    const Compare& cmp) const
+    {
+        auto val = [&](auto& suf) { return str[suf.pos]; };
+        auto by_rank = [](auto& l, auto& r) { return l.rank < r.rank; };
+        auto by_val = [&](auto& l, auto& r) { return cmp(val(l), val(r)); };
+
+        std::vector<suffix<Size>> sufs(str.size());
+        for_each(sufs, [&](size_t i) { sufs[i].pos = (Size)i; });
+        parallel::sort(sufs.begin(), sufs.end(), by_val, threads);
+        fill_first_rank(sufs, by_val);
+        for (Size shift = 1; !sorted(sufs); shift *= 2) {
+            fill_second_rank(sufs, shift);
+            parallel::sort(sufs.begin(), sufs.end(), by_rank, threads);
+            fill_first_rank(sufs, by_rank);
+        }
+        for_each(sufs, [&](size_t i) { idx[i] = sufs[i].pos; });
+    }
+
+private:
+    template <class Size>
+    struct suffix {
+        Size pos;
+        std::pair<Size, Size> rank;
+    };
+
+    template <class Size, class Function>
+    void for_each(const std::vector<suffix<Size>>& sufs, Function fn) const
+    {
+        parallel::for_each_chunk(
+            threads, sufs.size(), [&](size_t, size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i)
+                    fn(i);
+            });
+    }
+
+    /// The first rank is one plus the number of preceding distinct suffixes
+    template <class Size, class Cmp>
+    void fill_first_rank(std::vector<suffix<Size>>& sufs, Cmp cmp) const
+    {
+        std::vector<char> less(sufs.size());
+        std::vector<Size> uniq(threads + 1);
+        parallel::for_each_chunk(
+            threads, sufs.size(), [&](size_t chunk, size_t first, size_t last) {
+                for (size_t i = std::max<size_t>(first, 1); i < last; ++i)
+                    uniq[chunk + 1] += less[i] = cmp(sufs[i - 1], sufs[i]);
+            });
+        std::partial_sum(uniq.begin(), uniq.end(), uniq.begin());
+        parallel::for_each_chunk(
+            threads, sufs.size(), [&](size_t chunk, size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i)
+                    sufs[i].rank.first = 1 + (uniq[chunk] += less[i]);
+            });
+    }
+
+    template <class Size>
+    void fill_second_rank(std::vector<suffix<Size>>& sufs, Size shift) const
+    {
+        std::vector<Size> ranks(sufs.size());
+        for_each(sufs, [&](size_t i) {
+            ranks[sufs[i].pos] = sufs[i].rank.first;
+        });
+        auto at = shifted_value_or(shift, Size{});
+        for_each(sufs, [&](size_t i) {
+            sufs[i].rank.second = at(ranks, sufs[i].pos);
+        });
+    }
+
+    template <class Size>
+    static bool sorted(const std::vector<suffix<Size>>& sufs)
+    {
+        return sufs.empty() || sufs.back().rank.first == (Size)sufs.size();
+    }
+};
+
+/// Prefix doubling with radix sort of rank pairs.
+
+/// Larsson-Sadakane refinement: suffixes with a unique rank
+/// are excluded from the following rounds.
+/// Time complexity O(N*log(N)), space complexity O(N), where:
+/// N - text length.
+/// @see https://doi.org/10.1016/j.tcs.2007.07.017
+struct radix_doubling {
+    template <class T, class Size, class Compare>
+    void operator()(const std::vector<T>& str,
+                    std::vector<Size>& idx,
+                    const Compare& cmp) const
+    {
+        using group = std::pair<Size, Size>;  // half-open range of idx
+        const Size n = (Size)str.size();
+        auto rank = dense_ranks<Size>(str, cmp);
+        std::vector<Size> key(n), heads(n + Size{2}), active, sorted;
+        std::vector<group> groups, next;
+
+        // counting sort by characters, rank is the head of the group
+        for (Size pos = 0; pos < n; ++pos)
+            ++heads[rank[pos] + 1];
+        std::partial_sum(heads.begin(), heads.end(), heads.begin());
+        for (Size pos = 0; pos < n; ++pos)
+            idx[heads[rank[pos]]++] = pos;
+        split({Size{}, n}, idx, rank, groups, [&](Size pos) {
+            return rank[pos];
+        });
+
+        for (Size shift = 1; !groups.empty(); shift *= 2) {
+            active.clear();
+            for (auto [first, last] : groups)
+                active.insert(
+                    active.end(), idx.begin() + first, idx.begin() + last);
+            for (Size pos : active)
+                key[pos] = pos + shift < n ? rank[pos + shift] + 1 : 0;
+
+            // LSD: counting sort by the second rank,
+            // then stable distribution into the groups of the first rank
+            std::fill(heads.begin(), heads.end(), Size{});
+            for (Size pos : active)
+                ++heads[key[pos] + 1];
+            std::partial_sum(heads.begin(), heads.end(), heads.begin());
+            sorted.resize(active.size());
+            for (Size pos : active)
+                sorted[heads[key[pos]]++] = pos;
+            for (auto [first, last] : groups)
+                heads[first] = first;
+            for (Size pos : sorted)
+                idx[heads[rank[pos]]++] = pos;
+
+            next.clear();
+            for (auto grp : groups)
+                split(grp, idx, rank, next, [&](Size pos) {
+                    return key[pos];
+                });
+            groups.swap(next);
+        }
+    }
+
+private:
+    template <class Size, class Key>
+    static void split(std::pair<Size, Size> grp,
+                      const std::vector<Size>& idx,
+                      std::vector<Size>& rank,
+                      std::vector<std::pair<Size, Size>>& groups,
+                      Key key)
+    {
+        auto [first, last] = grp;
+        for (Size head = first, i = first; i < last; head = i) {
+            auto val = key(idx[i]);
+            while (i < last && key(idx[i]) == val)
+                ++i;
+            if (i - head > 1)
+                groups.emplace_back(head, i);
+            for (Size j = head; j < i; ++j)
+                rank[idx[j]] = head;
+        }
+    }
+};
+
+}  // namespace step
+
+#endif  // STEP_PREFIX_DOUBLING_HPP
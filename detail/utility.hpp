@@ -5,9 +5,12 @@
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <numeric>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -86,6 +89,28 @@ struct make_reverse_pair {
     }
 };
 
+/// @see https://en.cppreference.com/w/cpp/container/span
+template <class T>
+class span {
+    T* data_ = nullptr;
+    size_t size_ = 0;
+
+public:
+    constexpr span() = default;
+    constexpr span(T* data, size_t size) : data_{data}, size_{size} {}
+
+    template <class Rng>
+    constexpr span(Rng& rng) : span(std::data(rng), std::size(rng))
+    {
+    }
+
+    constexpr T* data() const { return data_; }
+    constexpr size_t size() const { return size_; }
+    constexpr T* begin() const { return data_; }
+    constexpr T* end() const { return data_ + size_; }
+    constexpr T& operator[](size_t i) const { return data_[i]; }
+};
+
 template <class T, size_t N>
 class ring_table {
     std::array<std::vector<T>, N> rows_;
@@ -100,6 +125,49 @@ public:
     auto& operator[](size_t row) { return rows_[row % N]; }
 };
 
+/// Scratch memory that keeps its capacity between the calls.
+
+/// Buffers are taken in the stack order and given back at the end of
+/// the enclosing scope. Elements are uninitialized, so only trivial types
+/// are allowed. It is not thread-safe.
+class workspace {
+public:
+    class scope {
+    public:
+        explicit scope(workspace& ws) : ws_{ws}, top_{ws.top_} {}
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+        ~scope() { ws_.top_ = top_; }
+
+    private:
+        workspace& ws_;
+        size_t top_;
+    };
+
+    template <class T>
+    span<T> get(size_t size)
+    {
+        static_assert(std::is_trivial_v<T>);
+        static_assert(alignof(T) <= alignof(block_t));
+        if (top_ == bufs_.size())
+            bufs_.emplace_back();
+        auto& buf = bufs_[top_++];
+        auto blocks =
+            (size * sizeof(T) + sizeof(block_t) - 1) / sizeof(block_t);
+        if (buf.size() < blocks)
+            buf.resize(blocks);
+        auto data = reinterpret_cast<T*>(buf.data());
+        std::uninitialized_default_construct_n(data, size);
+        return {data, size};
+    }
+
+private:
+    using block_t = std::max_align_t;
+
+    std::vector<std::vector<block_t>> bufs_;
+    size_t top_ = 0;
+};
+
 template <class T>
 std::enable_if_t<std::is_unsigned_v<T>, T> flip(T n)
 {
@@ -121,12 +189,70 @@ auto shifted_value_or(size_t shift, T default_value)
     };
 }
 
+/// Replace characters with their dense ranks in [0, K), where:
+/// K - alphabet size. Time complexity O(N) for byte and 16-bit alphabets,
+/// O(N*log(N)) otherwise.
+template <class Size, class RandomRng, class Compare>
+std::vector<Size> dense_ranks(const RandomRng& str, const Compare& cmp)
+{
+    using T = range_value_t<const RandomRng>;
+    std::vector<Size> result(std::size(str));
+    if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                  sizeof(T) <= 2) {
+        using key_t = std::make_unsigned_t<T>;
+        std::vector<bool> seen(size_t{1} << (8 * sizeof(T)));
+        for (auto val : str)
+            seen[(key_t)val] = true;
+        std::vector<T> alphabet;
+        for (size_t i = 0; i < seen.size(); ++i)
+            if (seen[i])
+                alphabet.push_back((T)i);
+        std::sort(alphabet.begin(), alphabet.end(), cmp);
+        std::vector<Size> ranks(seen.size());
+        for (size_t i = 1; i < alphabet.size(); ++i)
+            ranks[(key_t)alphabet[i]] =
+                ranks[(key_t)alphabet[i - 1]] +
+                (Size)cmp(alphabet[i - 1], alphabet[i]);
+        for (size_t i = 0; i < result.size(); ++i)
+            result[i] = ranks[(key_t)str[i]];
+    }
+    else {
+        std::vector<Size> order(result.size());
+        std::iota(order.begin(), order.end(), Size{});
+        std::sort(order.begin(), order.end(), [&](Size l, Size r) {
+            return cmp(str[l], str[r]);
+        });
+        for (size_t i = 1; i < order.size(); ++i)
+            result[order[i]] = result[order[i - 1]] +
+                               (Size)cmp(str[order[i - 1]], str[order[i]]);
+    }
+    return result;
+}
+
+template <class T, class It, class = std::void_t<>>
+struct has_append : std::false_type {
+};
+
+template <class T, class It>
+struct has_append<T,
+                  It,
+                  std::void_t<decltype(std::declval<T&>().append(
+                      std::declval<It>(), std::declval<It>()))>>
+    : std::true_type {
+};
+
 template <class T, class... It>
 void append(T& dest, std::pair<It, It>... src)
 {
     using size_type = decltype(dest.size());
     dest.reserve(dest.size() + ((size_type)size(src) + ...));
-    (std::copy(src.first, src.second, std::back_inserter(dest)), ...);
+    auto copy = [&](const auto& rng) {
+        if constexpr (has_append<T, decltype(rng.first)>::value)
+            dest.append(rng.first, rng.second);
+        else
+            std::copy(rng.first, rng.second, std::back_inserter(dest));
+    };
+    (copy(src), ...);
 }
 
 template <class Searcher, class... It>
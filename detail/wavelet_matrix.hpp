@@ -0,0 +1,127 @@
+// Andrew Naplavkov
+
+#ifndef STEP_WAVELET_MATRIX_HPP
+#define STEP_WAVELET_MATRIX_HPP
+
+#include "utility.hpp"
+
+namespace step {
+
+inline size_t popcount(uint64_t x)
+{
+    x -= (x >> 1) & 0x5555555555555555;
+    x = (x & 0x3333333333333333) + ((x >> 2) & 0x3333333333333333);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0f;
+    return (size_t)((x * 0x0101010101010101) >> 56);
+}
+
+/// Bit vector with constant time rank.
+
+/// Space complexity N*(1+1/8) bits, where: N - number of bits.
+class bit_vector {
+    std::vector<uint64_t> words_;
+    std::vector<uint64_t> ranks_;  // number of ones before every 8 words
+
+public:
+    bit_vector() = default;
+    explicit bit_vector(size_t size) : words_((size + 63) / 64) {}
+
+    bool operator[](size_t i) const { return (words_[i / 64] >> i % 64) & 1; }
+    void set(size_t i) { words_[i / 64] |= uint64_t{1} << i % 64; }
+
+    /// Shall be called after the last modification
+    void build_rank()
+    {
+        ranks_.resize(words_.size() / 8 + 1);
+        for (size_t i = 0, acc = 0; i < ranks_.size(); ++i) {
+            ranks_[i] = acc;
+            for (size_t j = i * 8; j < std::min(i * 8 + 8, words_.size()); ++j)
+                acc += popcount(words_[j]);
+        }
+    }
+
+    /// Return number of ones in [0, i)
+    size_t rank(size_t i) const
+    {
+        size_t word = i / 64;
+        size_t result = ranks_[word / 8];
+        for (size_t j = word / 8 * 8; j < word; ++j)
+            result += popcount(words_[j]);
+        if (i % 64)
+            result += popcount(words_[word] & ((uint64_t{1} << i % 64) - 1));
+        return result;
+    }
+};
+
+/// Sequence of integers with rank and access in O(log(K)),
+/// where: K - upper bound of integers.
+
+/// Space complexity N*log(K)*(1+1/8) bits, where: N - sequence length.
+/// @see https://doi.org/10.1016/j.is.2014.06.002
+template <class Size>
+class wavelet_matrix {
+    std::vector<bit_vector> levels_;
+    std::vector<size_t> zeros_;
+
+public:
+    wavelet_matrix() = default;
+
+    /// @param seq - integers in [0, upper]
+    wavelet_matrix(std::vector<Size> seq, Size upper)
+    {
+        size_t bits = 0;
+        while (bits < (size_t)std::numeric_limits<Size>::digits &&
+               (upper >> bits))
+            ++bits;
+        std::vector<Size> next(seq.size());
+        for (size_t shift = bits; shift-- > 0;) {
+            auto bit = [shift](Size val) { return (val >> shift) & 1; };
+            auto& level = levels_.emplace_back(seq.size());
+            for (size_t i = 0; i < seq.size(); ++i)
+                if (bit(seq[i]))
+                    level.set(i);
+            level.build_rank();
+            auto it = std::copy_if(
+                seq.begin(), seq.end(), next.begin(), [&](Size val) {
+                    return !bit(val);
+                });
+            zeros_.push_back(std::distance(next.begin(), it));
+            std::copy_if(seq.begin(), seq.end(), it, bit);
+            seq.swap(next);
+        }
+    }
+
+    Size operator[](size_t i) const
+    {
+        Size result = 0;
+        for (size_t l = 0; l < levels_.size(); ++l) {
+            bool bit = levels_[l][i];
+            result = Size(result << 1 | bit);
+            i = next(l, i, bit);
+        }
+        return result;
+    }
+
+    /// Return number of occurrences of the integer in [0, i)
+    size_t rank(Size val, size_t i) const
+    {
+        size_t first = 0;
+        for (size_t l = 0; l < levels_.size(); ++l) {
+            bool bit = (val >> (levels_.size() - 1 - l)) & 1;
+            first = next(l, first, bit);
+            i = next(l, i, bit);
+        }
+        return i - first;
+    }
+
+private:
+    size_t next(size_t level, size_t i, bool bit) const
+    {
+        size_t ones = levels_[level].rank(i);
+        return bit ? zeros_[level] + ones : i - ones;
+    }
+};
+
+}  // namespace step
+
+#endif  // STEP_WAVELET_MATRIX_HPP
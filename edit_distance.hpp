@@ -3,6 +3,8 @@
 #ifndef STEP_EDIT_DISTANCE_HPP
 #define STEP_EDIT_DISTANCE_HPP
 
+#include "detail/anti_diagonal.hpp"
+#include "detail/bit_parallel.hpp"
 #include "detail/hirschberg.hpp"
 #include <optional>
 
@@ -39,29 +41,40 @@ struct dynamic_programming {
     auto make_last_row(RandomIt1 first1,
                        RandomIt1 last1,
                        RandomIt2 first2,
-                       RandomIt2 last2) const
+                       RandomIt2 last2,
+                       workspace& ws) const
     {
-        size_t size1 = std::distance(first1, last1);
-        size_t size2 = std::distance(first2, last2);
-        ring_table<size_t, 2> tbl(size2 + 1);
-        for (size_t l = 0; l <= size1; ++l)
-            for (size_t r = 0; r <= size2; ++r) {
-                if (l == 0)
-                    tbl[l][r] = r;
-                else if (r == 0)
-                    tbl[l][r] = l;
-                else if (eq(first1[l - 1], first2[r - 1]))
-                    tbl[l][r] = tbl[l - 1][r - 1];
-                else
-                    tbl[l][r] = 1 + std::min({tbl[l][r - 1],        // insert
-                                              tbl[l - 1][r],        // remove
-                                              tbl[l - 1][r - 1]});  // replace
-            }
-        return std::move(tbl[size1]);
+        if constexpr (bit_parallel::enabled_v<Equal, RandomIt1, RandomIt2>)
+            return bit_parallel::levenshtein_last_row(
+                first1, last1, first2, last2, ws);
+        else
+            return anti_diagonal::last_row(
+                first1,
+                last1,
+                first2,
+                last2,
+                eq,
+                [](size_t i) { return i; },
+                [](bool match, auto diag, auto up, auto left) {
+                    // neighbors differ by one at most, so it is branch-free
+                    using cell_t = decltype(diag);
+                    return std::min(cell_t(diag + !match),
+                                    cell_t(1 + std::min(up, left)));
+                },
+                ws);
     }
 
     bool operator()(size_t lhs, size_t rhs) const { return lhs < rhs; }
 
+    template <class RandomIt1, class RandomIt2, class OutputIt>
+    OutputIt matched_trace(RandomIt1 first1,
+                           RandomIt1 last1,
+                           RandomIt2 first2,
+                           OutputIt result) const
+    {
+        return std::transform(first1, last1, first2, result, make_pair{});
+    }
+
     template <class RandomIt1, class RandomIt2, class OutputIt>
     OutputIt trivial_trace(RandomIt1 first1,
                            RandomIt1 last1,
@@ -86,6 +99,51 @@ struct dynamic_programming {
     }
 };
 
+template <class RandomIt1, class RandomIt2, class Equal>
+std::optional<size_t> banded_distance(RandomIt1 first1,
+                                      RandomIt1 last1,
+                                      RandomIt2 first2,
+                                      RandomIt2 last2,
+                                      size_t k,
+                                      const Equal& eq)
+{
+    size_t size1 = std::distance(first1, last1);
+    size_t size2 = std::distance(first2, last2);
+    if (std::max(size1, size2) - std::min(size1, size2) > k)
+        return std::nullopt;
+    k = std::min(k, std::max(size1, size2));
+    auto inf = k + 1;        // cells are saturated to keep the band finite
+    auto width = 2 * k + 3;  // cell (l, r) is at [l][r + k + 1 - l]
+    ring_table<size_t, 2> tbl(width);
+    std::fill(tbl[0].begin(), tbl[0].end(), inf);
+    for (size_t r = 0; r <= std::min(size2, k); ++r)
+        tbl[0][r + k + 1] = r;
+    for (size_t l = 1; l <= size1; ++l) {
+        auto& prev = tbl[l - 1];
+        auto& row = tbl[l];
+        std::fill(row.begin(), row.end(), inf);  // borders of the band
+        auto left = inf;
+        if (l <= k)
+            row[k + 1 - l] = left = l;  // the first column
+        auto best = left;
+        auto last = std::min(size2, l + k);
+        for (size_t r = l > k ? l - k : 1; r <= last; ++r) {
+            auto d = r + k + 1 - l;
+            auto edit = std::min({left,         // insert
+                                  prev[d + 1],  // remove
+                                  prev[d]});    // replace
+            left = eq(first1[l - 1], first2[r - 1]) ? prev[d]
+                                                    : std::min(inf, edit + 1);
+            row[d] = left;
+            best = std::min(best, left);
+        }
+        if (best > k)
+            return std::nullopt;
+    }
+    auto result = tbl[size1][size2 + k + 1 - size1];
+    return result > k ? std::nullopt : std::optional{result};
+}
+
 }  // namespace detail
 
 /// Find the optimal sequence alignment between two strings.
@@ -96,15 +154,21 @@ struct dynamic_programming {
 /// to change one string into the other.
 /// Time complexity O(N*M), space complexity O(min(N,M)), where:
 /// N = std::distance(first1, last1), M = std::distance(first2, last2).
+/// If the predicate is std::equal_to and the characters are hashable,
+/// rows are computed with bit-vectors in O(N*M/W) time, where:
+/// W - number of bits in the word.
 /// @see https://en.wikipedia.org/wiki/Levenshtein_distance
 /// @see https://en.wikipedia.org/wiki/Wagner%E2%80%93Fischer_algorithm
+/// @param threads - to split the halves of the problem between,
+///                   the predicate shall be safe to call concurrently.
 template <class RandomIt1, class RandomIt2, class OutputIt, class Equal>
 OutputIt join(RandomIt1 first1,
               RandomIt1 last1,
               RandomIt2 first2,
               RandomIt2 last2,
               OutputIt result,
-              Equal&& eq)
+              Equal&& eq,
+              size_t threads = 1)
 {
     return hirschberg::trace(
         first1,
@@ -112,7 +176,8 @@ OutputIt join(RandomIt1 first1,
         first2,
         last2,
         result,
-        detail::dynamic_programming<Equal>{std::forward<Equal>(eq)});
+        detail::dynamic_programming<Equal>{std::forward<Equal>(eq)},
+        threads);
 }
 
 template <class RandomIt1, class RandomIt2, class OutputIt>
@@ -130,14 +195,16 @@ template <class RandomRng1, class RandomRng2, class OutputIt, class Equal>
 OutputIt join(const RandomRng1& rng1,
               const RandomRng2& rng2,
               OutputIt result,
-              Equal&& eq)
+              Equal&& eq,
+              size_t threads = 1)
 {
     return edit_distance::join(std::begin(rng1),
                                std::end(rng1),
                                std::begin(rng2),
                                std::end(rng2),
                                result,
-                               std::forward<Equal>(eq));
+                               std::forward<Equal>(eq),
+                               threads);
 }
 
 template <class RandomRng1, class RandomRng2, class OutputIt>
@@ -150,6 +217,180 @@ OutputIt join(const RandomRng1& rng1, const RandomRng2& rng2, OutputIt result)
                                result);
 }
 
+/// Same, but the rows are taken from the workspace.
+
+/// No memory is allocated, once the workspace has grown for the inputs
+/// of this size.
+/// @param ws - to reuse between the calls, but not between the threads.
+template <class RandomIt1, class RandomIt2, class OutputIt, class Equal>
+OutputIt join(RandomIt1 first1,
+              RandomIt1 last1,
+              RandomIt2 first2,
+              RandomIt2 last2,
+              OutputIt result,
+              Equal&& eq,
+              workspace& ws)
+{
+    return hirschberg::trace(
+        first1,
+        last1,
+        first2,
+        last2,
+        result,
+        detail::dynamic_programming<Equal>{std::forward<Equal>(eq)},
+        ws);
+}
+
+template <class RandomRng1, class RandomRng2, class OutputIt, class Equal>
+OutputIt join(const RandomRng1& rng1,
+              const RandomRng2& rng2,
+              OutputIt result,
+              Equal&& eq,
+              workspace& ws)
+{
+    return edit_distance::join(std::begin(rng1),
+                               std::end(rng1),
+                               std::begin(rng2),
+                               std::end(rng2),
+                               result,
+                               std::forward<Equal>(eq),
+                               ws);
+}
+
+/// Find a sequence alignment, divided on the characters that occur once
+/// in each string.
+
+/// Unique characters are matched as in patience diff, and the gaps between
+/// them are aligned independently. It is faster on large inputs like lines
+/// of files, but the alignment is not necessarily optimal.
+/// Characters are compared with operator== and grouped by std::hash.
+template <class RandomIt1, class RandomIt2, class OutputIt>
+OutputIt anchored_join(RandomIt1 first1,
+                       RandomIt1 last1,
+                       RandomIt2 first2,
+                       RandomIt2 last2,
+                       OutputIt result)
+{
+    return hirschberg::anchored_trace(
+        first1,
+        last1,
+        first2,
+        last2,
+        result,
+        detail::dynamic_programming<std::equal_to<>>{});
+}
+
+template <class RandomRng1, class RandomRng2, class OutputIt>
+OutputIt anchored_join(const RandomRng1& rng1,
+                       const RandomRng2& rng2,
+                       OutputIt result)
+{
+    return edit_distance::anchored_join(std::begin(rng1),
+                                        std::end(rng1),
+                                        std::begin(rng2),
+                                        std::end(rng2),
+                                        result);
+}
+
+/// Find the Levenshtein distance between two strings.
+
+/// Time complexity O(N*M), space complexity O(M), where:
+/// N = std::distance(first1, last1), M = std::distance(first2, last2).
+/// If the predicate is std::equal_to and the characters are hashable,
+/// the time complexity is O(N*M/W), where: W - number of bits in the word.
+template <class RandomIt1, class RandomIt2, class Equal>
+size_t distance(RandomIt1 first1,
+                RandomIt1 last1,
+                RandomIt2 first2,
+                RandomIt2 last2,
+                Equal&& eq)
+{
+    auto dp = detail::dynamic_programming<Equal>{std::forward<Equal>(eq)};
+    auto ws = workspace{};
+    auto row = dp.make_last_row(first1, last1, first2, last2, ws);
+    return row[row.size() - 1];
+}
+
+template <class RandomIt1, class RandomIt2>
+size_t distance(RandomIt1 first1,
+                RandomIt1 last1,
+                RandomIt2 first2,
+                RandomIt2 last2)
+{
+    return edit_distance::distance(
+        first1, last1, first2, last2, std::equal_to{});
+}
+
+template <class RandomRng1, class RandomRng2, class Equal>
+size_t distance(const RandomRng1& rng1, const RandomRng2& rng2, Equal&& eq)
+{
+    return edit_distance::distance(std::begin(rng1),
+                                   std::end(rng1),
+                                   std::begin(rng2),
+                                   std::end(rng2),
+                                   std::forward<Equal>(eq));
+}
+
+template <class RandomRng1, class RandomRng2>
+size_t distance(const RandomRng1& rng1, const RandomRng2& rng2)
+{
+    return edit_distance::distance(
+        std::begin(rng1), std::end(rng1), std::begin(rng2), std::end(rng2));
+}
+
+/// Find the Levenshtein distance if it does not exceed the threshold.
+
+/// Only the cells within k of the main diagonal are computed,
+/// the scan stops as soon as every cell of the band exceeds k.
+/// Time complexity O(k*min(N,M)), space complexity O(k), where:
+/// N = std::distance(first1, last1), M = std::distance(first2, last2).
+/// @return std::nullopt if the distance is greater than k
+/// @see https://doi.org/10.1016/S0019-9958(85)80046-2
+template <class RandomIt1, class RandomIt2, class Equal>
+std::optional<size_t> distance_bounded(RandomIt1 first1,
+                                       RandomIt1 last1,
+                                       RandomIt2 first2,
+                                       RandomIt2 last2,
+                                       size_t k,
+                                       const Equal& eq)
+{
+    return detail::banded_distance(first1, last1, first2, last2, k, eq);
+}
+
+template <class RandomIt1, class RandomIt2>
+std::optional<size_t> distance_bounded(RandomIt1 first1,
+                                       RandomIt1 last1,
+                                       RandomIt2 first2,
+                                       RandomIt2 last2,
+                                       size_t k)
+{
+    return edit_distance::distance_bounded(
+        first1, last1, first2, last2, k, std::equal_to{});
+}
+
+template <class RandomRng1, class RandomRng2, class Equal>
+std::optional<size_t> distance_bounded(const RandomRng1& rng1,
+                                       const RandomRng2& rng2,
+                                       size_t k,
+                                       const Equal& eq)
+{
+    return edit_distance::distance_bounded(std::begin(rng1),
+                                           std::end(rng1),
+                                           std::begin(rng2),
+                                           std::end(rng2),
+                                           k,
+                                           eq);
+}
+
+template <class RandomRng1, class RandomRng2>
+std::optional<size_t> distance_bounded(const RandomRng1& rng1,
+                                       const RandomRng2& rng2,
+                                       size_t k)
+{
+    return edit_distance::distance_bounded(
+        std::begin(rng1), std::end(rng1), std::begin(rng2), std::end(rng2), k);
+}
+
 }  // namespace step::edit_distance
 
 #endif  // STEP_EDIT_DISTANCE_HPP
@@ -0,0 +1,225 @@
+// Andrew Naplavkov
+
+#ifndef STEP_FLAT_MAP_HPP
+#define STEP_FLAT_MAP_HPP
+
+#include "detail/utility.hpp"
+#include <initializer_list>
+#include <memory>
+
+namespace step {
+
+/// Sorted associative container with inline storage for a few elements.
+
+/// Drop-in replacement of std::map for suffix_tree nodes, that mostly have
+/// two or three children. Elements are kept in contiguous array, it resides
+/// in the object itself until it is outgrown, so small maps do not allocate.
+/// Insertion and erasure invalidate iterators, time complexity O(N).
+/// @code step::suffix_tree<char, uint32_t, step::flat_map> tree; @endcode
+template <class Key,
+          class T,
+          class Compare = std::less<Key>,
+          class Allocator = std::allocator<std::pair<Key, T>>>
+class flat_map : private Allocator {  // empty base optimization
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using size_type = size_t;
+    using key_compare = Compare;
+    using allocator_type = Allocator;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+
+    flat_map() = default;
+
+    explicit flat_map(const Allocator& alloc) : Allocator(alloc) {}
+
+    flat_map(std::initializer_list<value_type> init,
+             const Allocator& alloc = Allocator())
+        : Allocator(alloc)
+    {
+        for (auto& val : init)
+            insert(val);
+    }
+
+    flat_map(const flat_map& other, const Allocator& alloc) : Allocator(alloc)
+    {
+        if (other.size_ > inline_capacity)
+            grow(other.size_);
+        std::copy(other.begin(), other.end(), data());
+        size_ = other.size_;
+    }
+
+    flat_map(const flat_map& other)
+        : flat_map(other,
+                   alloc_traits::select_on_container_copy_construction(
+                       other.get_allocator()))
+    {
+    }
+
+    flat_map(flat_map&& other) noexcept : Allocator(std::move(other))
+    {
+        steal(other);
+    }
+
+    flat_map& operator=(const flat_map& other)
+    {
+        if (this != &other)
+            *this = flat_map(other, get_allocator());
+        return *this;
+    }
+
+    flat_map& operator=(flat_map&& other) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value)
+    {
+        if (this == &other)
+            return *this;
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::
+                          value) {
+            deallocate();
+            static_cast<Allocator&>(*this) = std::move(other);
+        }
+        else if (get_allocator() != other.get_allocator())
+            return *this = flat_map(other, get_allocator());
+        else
+            deallocate();
+        steal(other);
+        return *this;
+    }
+
+    ~flat_map() { deallocate(); }
+
+    allocator_type get_allocator() const { return *this; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + size_; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size_; }
+    size_type size() const { return size_; }
+    bool empty() const { return !size_; }
+
+    iterator find(const Key& key) { return search(begin(), end(), key); }
+
+    const_iterator find(const Key& key) const
+    {
+        return search(begin(), end(), key);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& val)
+    {
+        auto it = lower_bound(begin(), end(), val.first);
+        if (it != end() && !cmp_(val.first, it->first))
+            return {it, false};
+        return {emplace(it, val), true};
+    }
+
+    T& operator[](const Key& key)
+    {
+        auto it = lower_bound(begin(), end(), key);
+        if (it == end() || cmp_(key, it->first))
+            it = emplace(it, value_type{key, T{}});
+        return it->second;
+    }
+
+    size_type erase(const Key& key)
+    {
+        auto it = find(key);
+        if (it == end())
+            return 0;
+        std::move(it + 1, end(), it);
+        --size_;
+        return 1;
+    }
+
+private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+    static constexpr uint32_t inline_capacity =
+        std::max<uint32_t>(2, 24 / sizeof(value_type));
+
+    inline static const auto cmp_ = Compare{};
+
+    value_type* heap_ = nullptr;
+    uint32_t size_ = 0;
+    uint32_t capacity_ = inline_capacity;
+    value_type inline_[inline_capacity];
+
+    value_type* data() { return heap_ ? heap_ : inline_; }
+    const value_type* data() const { return heap_ ? heap_ : inline_; }
+
+    template <class It>
+    static It lower_bound(It first, It last, const Key& key)
+    {
+        return std::lower_bound(
+            first, last, key, [](const value_type& val, const Key& key) {
+                return cmp_(val.first, key);
+            });
+    }
+
+    template <class It>
+    static It search(It first, It last, const Key& key)
+    {
+        auto it = lower_bound(first, last, key);
+        return it != last && !cmp_(key, it->first) ? it : last;
+    }
+
+    iterator emplace(iterator pos, value_type val)
+    {
+        auto i = std::distance(begin(), pos);
+        if (size_ == capacity_)
+            grow(capacity_ * 2);
+        std::move_backward(begin() + i, end(), end() + 1);
+        begin()[i] = std::move(val);
+        ++size_;
+        return begin() + i;
+    }
+
+    /// Heap array is fully constructed to shift elements by assignment
+    void grow(uint32_t capacity)
+    {
+        value_type* ptr = alloc_traits::allocate(*this, capacity);
+        uint32_t i = 0;
+        try {
+            for (; i < capacity; ++i)
+                alloc_traits::construct(*this, ptr + i);
+        }
+        catch (...) {
+            while (i)
+                alloc_traits::destroy(*this, ptr + --i);
+            alloc_traits::deallocate(*this, ptr, capacity);
+            throw;
+        }
+        std::move(begin(), end(), ptr);
+        deallocate();
+        heap_ = ptr;
+        capacity_ = capacity;
+    }
+
+    void deallocate() noexcept
+    {
+        if (!heap_)
+            return;
+        for (uint32_t i = 0; i < capacity_; ++i)
+            alloc_traits::destroy(*this, heap_ + i);
+        alloc_traits::deallocate(*this, heap_, capacity_);
+        heap_ = nullptr;
+        capacity_ = inline_capacity;
+    }
+
+    void steal(flat_map& other) noexcept
+    {
+        if (other.heap_) {
+            heap_ = std::exchange(other.heap_, nullptr);
+            capacity_ = std::exchange(other.capacity_, inline_capacity);
+        }
+        else
+            std::move(other.begin(), other.end(), inline_);
+        size_ = std::exchange(other.size_, 0);
+    }
+};
+
+}  // namespace step
+
+#endif  // STEP_FLAT_MAP_HPP
@@ -0,0 +1,171 @@
+// Andrew Naplavkov
+
+#ifndef STEP_FM_INDEX_HPP
+#define STEP_FM_INDEX_HPP
+
+#include "detail/wavelet_matrix.hpp"
+#include "suffix_array.hpp"
+
+namespace step {
+
+/// Compressed full-text index over the Burrows-Wheeler transform.
+
+/// The transform is stored in a wavelet matrix, the offsets of the suffixes
+/// are sampled. Space complexity N*log(K)*(1+1/8) bits plus N/S offsets,
+/// where: N - text length, K - alphabet size, S - sample rate.
+/// The text itself is not stored.
+/// @param T - type of the characters;
+/// @param Size - to specify the maximum number / offset of characters;
+/// @param Compare - to determine the order of characters.
+/// @see https://en.wikipedia.org/wiki/FM-index
+template <class T = char, class Size = size_t, class Compare = std::less<>>
+class fm_index {
+public:
+    using value_type = T;
+    using size_type = Size;
+
+    fm_index() = default;
+
+    /// @param arr - suffix array of the text;
+    /// @param sample_rate - the offset of every suffix that is a multiple
+    /// of sample_rate is stored, it trades space for the speed of find_all.
+    explicit fm_index(const suffix_array_view<T, Size, Compare>& arr,
+                      Size sample_rate = 32)
+        : size_{arr.size()}
+        , sample_rate_{std::max<Size>(sample_rate, 1)}
+        , sampled_{size_t{size_} + 1}
+    {
+        auto str = span<const T>{arr.data(), arr.size()};
+        auto ranks = dense_ranks<Size>(str, cmp_);
+        Size alphabet_size = 0;
+        for (auto rank : ranks)
+            alphabet_size = std::max<Size>(alphabet_size, rank + 1);
+        alphabet_.resize(alphabet_size);
+        for (size_t i = 0; i < ranks.size(); ++i)
+            alphabet_[ranks[i]] = str[i];
+
+        // the text is terminated by a virtual sentinel, it is the least symbol
+        auto preceding = [&](Size pos) {
+            return pos ? Size(ranks[pos - 1] + 1) : Size{};
+        };
+        auto sample = [&](size_t row, Size pos) {
+            if (pos % sample_rate_ == 0) {
+                sampled_.set(row);
+                samples_.push_back(pos);
+            }
+        };
+        std::vector<Size> bwt(size_t{size_} + 1);
+        bwt[0] = preceding(size_);
+        sample(0, size_);
+        for (Size i = 0; i < size_; ++i) {
+            auto pos = arr.nth_element(i);
+            bwt[i + size_t{1}] = preceding(pos);
+            sample(i + size_t{1}, pos);
+        }
+        sampled_.build_rank();
+        counts_.assign(alphabet_size + size_t{2}, 0);
+        for (auto sym : bwt)
+            ++counts_[sym + size_t{1}];
+        std::partial_sum(counts_.begin(), counts_.end(), counts_.begin());
+        bwt_ = wavelet_matrix<Size>(std::move(bwt), alphabet_size);
+    }
+
+    Size size() const { return size_; }
+
+    /// Count occurrences of the substring.
+
+    /// Time complexity O(M*log(K)), where:
+    /// M - substring length, K - alphabet size.
+    template <class BidirIt>
+    Size count(BidirIt first, BidirIt last) const
+    {
+        auto [lo, hi] = rows(first, last);
+        return Size(hi - lo);
+    }
+
+    template <class BidirRng>
+    Size count(const BidirRng& rng) const
+    {
+        return count(std::begin(rng), std::end(rng));
+    }
+
+    /// Find all occurrences of the substring.
+
+    /// Time complexity O((M+Z*S)*log(K)), where: M - substring length,
+    /// Z - number of occurrences, S - sample rate, K - alphabet size.
+    /// @param result - receives offsets in lexicographical order of suffixes.
+    template <class BidirIt, class OutputIt>
+    OutputIt find_all(BidirIt first, BidirIt last, OutputIt result) const
+    {
+        auto [lo, hi] = rows(first, last);
+        for (; lo < hi; ++lo)
+            *result++ = locate(lo);
+        return result;
+    }
+
+    template <class BidirRng, class OutputIt>
+    OutputIt find_all(const BidirRng& rng, OutputIt result) const
+    {
+        return find_all(std::begin(rng), std::end(rng), result);
+    }
+
+private:
+    Size size_ = 0;
+    Size sample_rate_ = 1;
+    Compare cmp_;
+    std::vector<T> alphabet_;
+    std::vector<size_t> counts_;  // number of lesser symbols
+    wavelet_matrix<Size> bwt_;
+    bit_vector sampled_;
+    std::vector<Size> samples_;
+
+    /// Backward search of the half-open range of sorted suffixes
+    template <class BidirIt>
+    std::pair<size_t, size_t> rows(BidirIt first, BidirIt last) const
+    {
+        if (first == last)
+            return {1, size_t{size_} + 1};  // except the sentinel
+        size_t lo = 0, hi = size_t{size_} + 1;
+        while (first != last && lo < hi) {
+            const T& val = *--last;
+            auto it = std::lower_bound(
+                alphabet_.begin(), alphabet_.end(), val, cmp_);
+            if (it == alphabet_.end() || cmp_(val, *it))
+                return {};
+            auto sym = Size(std::distance(alphabet_.begin(), it) + 1);
+            lo = counts_[sym] + bwt_.rank(sym, lo);
+            hi = counts_[sym] + bwt_.rank(sym, hi);
+        }
+        return {lo, hi};
+    }
+
+    /// LF-mapping to the nearest sampled row
+    Size locate(size_t row) const
+    {
+        Size steps = 0;
+        for (; !sampled_[row]; ++steps) {
+            auto sym = bwt_[row];
+            row = counts_[sym] + bwt_.rank(sym, row);
+        }
+        return Size(samples_[sampled_.rank(row)] + steps);
+    }
+};
+
+template <class T, class Size, class Compare>
+fm_index(const suffix_array_view<T, Size, Compare>&)
+    -> fm_index<T, Size, Compare>;
+
+template <class T, class Size, class Compare>
+fm_index(const suffix_array_view<T, Size, Compare>&, size_t)
+    -> fm_index<T, Size, Compare>;
+
+template <class T, class Size, class Compare>
+fm_index(const suffix_array<T, Size, Compare>&) -> fm_index<T, Size, Compare>;
+
+template <class T, class Size, class Compare>
+fm_index(const suffix_array<T, Size, Compare>&, size_t)
+    -> fm_index<T, Size, Compare>;
+
+}  // namespace step
+
+#endif  // STEP_FM_INDEX_HPP
@@ -0,0 +1,410 @@
+// Andrew Naplavkov
+
+#ifndef STEP_GENERALIZED_SUFFIX_TREE_HPP
+#define STEP_GENERALIZED_SUFFIX_TREE_HPP
+
+#include "detail/utility.hpp"
+#include <optional>
+#include <unordered_map>
+
+namespace step {
+
+/// Ukkonen's online algorithm for constructing generalized suffix tree.
+
+/// Every document is padded with an implicit unique terminator, that is not
+/// a character of T, so the tree is explicit after each push_back.
+/// Each leaf knows its document.
+/// Time complexity O(N*log(K)), space complexity O(N), where:
+/// N - total length of the documents, K - alphabet size.
+/// @param T - type of the characters;
+/// @param Size - to specify the maximum number / offset of characters
+///               and documents;
+/// @param Map - to associate characters with edges, its key_type shall be T;
+/// @param Allocator - for the text and the nodes.
+/// @see https://en.wikipedia.org/wiki/Generalized_suffix_tree
+template <class T = char,
+          class Size = size_t,
+          template <class...> class Map = std::unordered_map,
+          class Allocator = std::allocator<T>>
+class generalized_suffix_tree {
+public:
+    using value_type = T;
+    using size_type = Size;
+    using allocator_type = Allocator;
+    using substring = std::pair<Size, Size>;   ///< half-open offset range
+    using occurrence = std::pair<Size, Size>;  ///< document and offset in it
+
+    generalized_suffix_tree() = default;
+
+    explicit generalized_suffix_tree(const Allocator& alloc)
+        : str_(alloc)
+        , docs_(alloc)
+        , ends_(alloc)
+        , next_(alloc)
+        , nodes_(alloc)
+        , df_(alloc)
+    {
+    }
+
+    allocator_type get_allocator() const { return str_.get_allocator(); }
+
+    /// Number of documents
+    Size size() const { return (Size)ends_.size(); }
+
+    const T* data(Size doc) const { return str_.data() + begin(doc); }
+    Size size(Size doc) const { return ends_[doc] - begin(doc); }
+
+    void clear() noexcept
+    {
+        str_.clear();
+        docs_.clear();
+        ends_.clear();
+        next_.clear();
+        nodes_.clear();
+        df_.clear();
+        char_ = node_ = suffix_ = 0;
+    }
+
+    /// @param len - total length of the documents plus their number
+    void reserve(Size len)
+    {
+        str_.reserve(len);
+        docs_.reserve(len);
+        next_.reserve(len);
+        nodes_.reserve(len);
+    }
+
+    /// Append the document, return its number.
+
+    /// Basic exception guarantee
+    template <class InputIt>
+    Size push_back(InputIt first, InputIt last)
+    try {
+        df_.clear();
+        if (nodes_.empty())
+            nodes_.push_back({make_map(), {}, {}, {}});
+        for (; first != last; ++first)
+            extend(*first);
+        terminate();
+        return size() - 1;
+    }
+    catch (...) {
+        clear();
+        throw;
+    }
+
+    template <class InputRng>
+    Size push_back(const InputRng& rng)
+    {
+        return push_back(std::begin(rng), std::end(rng));
+    }
+
+    /// Find all occurrences of the substring in the documents.
+
+    /// Time complexity O(M+Z), where:
+    /// M - substring length, Z - number of occurrences.
+    /// The order of occurrences is unspecified.
+    template <class InputIt, class OutputIt>
+    OutputIt find_all(InputIt first, InputIt last, OutputIt result) const
+    {
+        if (auto edge = find_edge(first, last))
+            dfs(edge->first, edge->second, [&](Size suffix) {
+                Size doc = docs_[suffix];
+                *result++ = occurrence{doc, Size(suffix - begin(doc))};
+            });
+        return result;
+    }
+
+    template <class InputRng, class OutputIt>
+    OutputIt find_all(const InputRng& rng, OutputIt result) const
+    {
+        return find_all(std::begin(rng), std::end(rng), result);
+    }
+
+    /// Count the documents containing the substring.
+
+    /// Time complexity O(M) after build_document_frequency,
+    /// O(M+Z*log(Z)) otherwise.
+    template <class InputIt>
+    Size document_frequency(InputIt first, InputIt last) const
+    {
+        auto edge = find_edge(first, last);
+        if (!edge)
+            return 0;
+        if (!df_.empty())
+            return leaf(edge->first) ? 1 : df_[edge->first];
+        auto docs = std::vector<Size>{};
+        dfs(edge->first, edge->second, [&](Size suffix) {
+            docs.push_back(docs_[suffix]);
+        });
+        std::sort(docs.begin(), docs.end());
+        return Size(std::unique(docs.begin(), docs.end()) - docs.begin());
+    }
+
+    template <class InputRng>
+    Size document_frequency(const InputRng& rng) const
+    {
+        return document_frequency(std::begin(rng), std::end(rng));
+    }
+
+    /// Count the documents below every node, push_back drops the counters.
+
+    /// Hui's algorithm: each leaf adds one to its parent, the lowest common
+    /// ancestor of the leaf and the previous leaf of the same document
+    /// subtracts one. Ancestors are on the depth-first stack ordered by
+    /// the entry time, so the lowest common one is found by binary search.
+    /// Time complexity O(N*log(N)), space complexity O(N).
+    void build_document_frequency()
+    {
+        using iterator = typename map_type::const_iterator;
+        struct frame {
+            Size node;
+            Size time;  // number of leaves before the node
+            iterator it;
+        };
+        df_.assign(nodes(), 0);
+        auto prev = std::vector<Size>(size());  // one-based time of the leaf
+        auto stack = std::vector<frame>{};
+        Size time = 0;
+        auto count = [&](Size doc) {
+            ++df_[stack.back().node];
+            if (Size last = std::exchange(prev[doc], ++time)) {
+                auto it = std::upper_bound(
+                    stack.begin(),
+                    stack.end(),
+                    last - 1,
+                    [](Size lhs, const frame& rhs) { return lhs < rhs.time; });
+                --df_[std::prev(it)->node];  // modulo arithmetic
+            }
+        };
+        auto enter = [&](Size node) {
+            stack.push_back({node, time, nodes_[node].children.begin()});
+            suffixes(node, [&](Size suffix) { count(docs_[suffix]); });
+        };
+        if (!nodes_.empty())
+            enter(0);
+        while (!stack.empty()) {
+            auto& top = stack.back();
+            if (top.it == nodes_[top.node].children.end()) {
+                Size node = top.node;
+                stack.pop_back();
+                if (!stack.empty())
+                    df_[stack.back().node] += df_[node];
+            }
+            else if (Size child = (top.it++)->second; leaf(child))
+                count(docs_[flip(child)]);
+            else
+                enter(child);
+        }
+    }
+
+private:
+    using map_type = Map<T, Size>;
+
+    inline static const auto eq_ = key_equal_or_equivalence_t<map_type>{};
+
+    struct inner_node {
+        map_type children;
+        substring rng;
+        Size link;
+        Size term;  // one-based first suffix ending at the node
+    };
+
+    template <class U>
+    using rebind_alloc =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<U>;
+
+    // documents with placeholders of their terminators
+    std::vector<T, Allocator> str_;
+    std::vector<Size, rebind_alloc<Size>> docs_;  // document of the offset
+    std::vector<Size, rebind_alloc<Size>> ends_;  // offset of the terminator
+    std::vector<Size, rebind_alloc<Size>> next_;  // suffixes at the same node
+    std::vector<inner_node, rebind_alloc<inner_node>> nodes_;
+    Size char_{}, node_{};  // active
+    Size suffix_{};         // the first one without a leaf
+    std::vector<Size, rebind_alloc<Size>> df_;  // document frequency
+
+    Size length() const { return (Size)str_.size(); }
+    Size reminder() const { return length() - char_; }
+    Size nodes() const { return (Size)nodes_.size(); }
+    bool leaf(Size node) const { return node >= nodes(); }
+    Size begin(Size doc) const { return doc ? ends_[doc - 1] + 1 : 0; }
+
+    /// Leaves of the last document are open until its terminator
+    substring range(Size node) const
+    {
+        if (!leaf(node))
+            return nodes_[node].rng;
+        Size first = flip(node);
+        Size doc = docs_[first];
+        return {first, doc < size() ? ends_[doc] : length()};
+    }
+
+    map_type make_map() const
+    {
+        if constexpr (std::uses_allocator_v<map_type, Allocator>)
+            return map_type(get_allocator());
+        else
+            return map_type{};
+    }
+
+    auto make_tie()
+    {
+        return [&, src = Size{}](Size dest, Size next) mutable {
+            if (src)
+                nodes_[src].link = dest;
+            src = next;  // waits for the suffix link
+        };
+    }
+
+    void push(T val)
+    {
+        str_.push_back(val);
+        docs_.push_back(size());
+        next_.push_back(0);
+    }
+
+    void extend(T val)
+    {
+        push(val);
+        auto tie = make_tie();
+        while (reminder()) {
+            if (Size& child = nodes_[node_].children[str_[char_]]) {
+                if (descend(child))
+                    continue;
+                Size back = length() - 1;
+                auto rng = range(child);
+                Size cut = rng.first + (back - char_);
+                if (cut < rng.second && eq_(str_[cut], str_[back]))
+                    return tie(node_, 0);
+                Size node = split(child, cut, back - suffix_);
+                nodes_[node].children[str_[back]] = flip(back);
+                tie(node, node);
+            }
+            else {
+                child = flip(char_);
+                tie(node_, 0);
+            }
+            ++suffix_;
+            node_ ? node_ = nodes_[node_].link : ++char_;
+        }
+    }
+
+    /// The rest of the suffixes end at the unique terminator
+    void terminate()
+    {
+        Size back = length();
+        push(T{});  // never compared
+        ends_.push_back(back);
+        auto tie = make_tie();
+        while (suffix_ < back) {
+            Size node = node_;
+            if (char_ < back) {
+                Size& child =
+                    nodes_[node_].children.find(str_[char_])->second;
+                if (descend(child))
+                    continue;
+                node = split(
+                    child, range(child).first + (back - char_), back - suffix_);
+                tie(node, node);
+            }
+            else
+                tie(node, 0);
+            enlist(node, suffix_++);
+            node_ ? node_ = nodes_[node_].link : ++char_;
+        }
+        char_ = suffix_ = length();
+        node_ = 0;
+    }
+
+    bool descend(Size node)
+    {
+        Size len = step::size(range(node));
+        if (leaf(node) || reminder() <= len)
+            return false;
+        char_ += len;
+        node_ = node;
+        return true;
+    }
+
+    /// Return the new inner node of depth above cut
+    Size split(Size& child, Size cut, Size depth)
+    {
+        auto rng = range(child);
+        Size node = nodes();
+        Size old = std::exchange(child, node);
+        auto children = make_map();
+        if (cut < rng.second)
+            children[str_[cut]] = leaf(old) ? flip(cut) : old;
+        nodes_.push_back({std::move(children), {rng.first, cut}, {}, {}});
+        if (cut == rng.second)  // the leaf is left with its terminator
+            enlist(node, cut - depth);
+        else if (!leaf(old))
+            nodes_[old].rng.first = cut;
+        return node;
+    }
+
+    void enlist(Size node, Size suffix)
+    {
+        next_[suffix] = std::exchange(nodes_[node].term, suffix + 1);
+    }
+
+    /// Call f with the first offset of each suffix ending at the node
+    template <class UnaryFunction>
+    void suffixes(Size node, UnaryFunction&& f) const
+    {
+        for (Size suffix = nodes_[node].term; suffix--; suffix = next_[suffix])
+            f(suffix);
+    }
+
+    /// Return the node below the substring and the length of its path
+    template <class InputIt>
+    std::optional<std::pair<Size, Size>> find_edge(InputIt first,
+                                                   InputIt last) const
+    {
+        for (Size node = 0, path = 0; !nodes_.empty();) {
+            auto rng = range(node);
+            path += step::size(rng);
+            auto diff = std::mismatch(first,
+                                      last,
+                                      str_.data() + rng.first,
+                                      str_.data() + rng.second,
+                                      eq_);
+            if (diff.first == last)
+                return std::pair{node, path};
+            if (diff.second != str_.data() + rng.second || leaf(node))
+                break;
+            auto& children = nodes_[node].children;
+            auto it = children.find(*diff.first);
+            if (it == children.end())
+                break;
+            first = diff.first;
+            node = it->second;
+        }
+        return std::nullopt;
+    }
+
+    /// Call f with the first offset of each suffix below the node
+    template <class UnaryFunction>
+    void dfs(Size node, Size path, UnaryFunction f) const
+    {
+        for (auto stack = std::vector<std::pair<Size, Size>>{{node, path}};
+             !stack.empty();) {
+            auto [top, depth] = stack.back();
+            stack.pop_back();
+            if (leaf(top)) {
+                f(range(top).second - depth);
+                continue;
+            }
+            suffixes(top, f);
+            for (auto& pair : nodes_[top].children) {
+                Size len = step::size(range(pair.second));
+                stack.push_back({pair.second, Size(depth + len)});
+            }
+        }
+    }
+};
+
+}  // namespace step
+
+#endif  // STEP_GENERALIZED_SUFFIX_TREE_HPP
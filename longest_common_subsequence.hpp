@@ -3,7 +3,10 @@
 #ifndef STEP_LONGEST_COMMON_SUBSEQUENCE_HPP
 #define STEP_LONGEST_COMMON_SUBSEQUENCE_HPP
 
+#include "detail/anti_diagonal.hpp"
+#include "detail/bit_parallel.hpp"
 #include "detail/hirschberg.hpp"
+#include "detail/myers.hpp"
 
 namespace step::longest_common_subsequence {
 namespace detail {
@@ -16,21 +19,38 @@ struct dynamic_programming {
     auto make_last_row(RandomIt1 first1,
                        RandomIt1 last1,
                        RandomIt2 first2,
-                       RandomIt2 last2) const
+                       RandomIt2 last2,
+                       workspace& ws) const
     {
-        size_t size1 = std::distance(first1, last1);
-        size_t size2 = std::distance(first2, last2);
-        ring_table<size_t, 2> tbl(size2 + 1);
-        for (size_t l = 1; l <= size1; ++l)
-            for (size_t r = 1; r <= size2; ++r)
-                tbl[l][r] = eq(first1[l - 1], first2[r - 1])
-                                ? tbl[l - 1][r - 1] + 1
-                                : std::max(tbl[l - 1][r], tbl[l][r - 1]);
-        return std::move(tbl[size1]);
+        if constexpr (bit_parallel::enabled_v<Equal, RandomIt1, RandomIt2>)
+            return bit_parallel::lcs_last_row(first1, last1, first2, last2, ws);
+        else
+            return anti_diagonal::last_row(
+                first1,
+                last1,
+                first2,
+                last2,
+                eq,
+                [](size_t) { return 0; },
+                [](bool match, auto diag, auto up, auto left) {
+                    // neighbors differ by one at most, so it is branch-free
+                    using cell_t = decltype(diag);
+                    return std::max(cell_t(diag + match), std::max(up, left));
+                },
+                ws);
     }
 
     bool operator()(size_t lhs, size_t rhs) const { return lhs > rhs; }
 
+    template <class RandomIt1, class RandomIt2, class OutputIt>
+    OutputIt matched_trace(RandomIt1 first1,
+                           RandomIt1 last1,
+                           RandomIt2,
+                           OutputIt result) const
+    {
+        return std::copy(first1, last1, result);
+    }
+
     template <class RandomIt1, class RandomIt2, class OutputIt>
     OutputIt trivial_trace(RandomIt1 first1,
                            RandomIt1 last1,
@@ -53,15 +73,21 @@ struct dynamic_programming {
 /// but not necessarily contiguous.
 /// Time complexity O(N*M), space complexity O(min(N,M)), where:
 /// N = std::distance(first1, last1), M = std::distance(first2, last2).
+/// If the predicate is std::equal_to and the elements are hashable,
+/// rows are computed with bit-vectors in O(N*M/W) time, where:
+/// W - number of bits in the word.
 /// @see https://en.wikipedia.org/wiki/Longest_common_subsequence_problem
 /// @see https://www.geeksforgeeks.org/longest-common-subsequence/
+/// @param threads - to split the halves of the problem between,
+///                   the predicate shall be safe to call concurrently.
 template <class RandomIt1, class RandomIt2, class OutputIt, class Equal>
 OutputIt intersection(RandomIt1 first1,
                       RandomIt1 last1,
                       RandomIt2 first2,
                       RandomIt2 last2,
                       OutputIt result,
-                      Equal&& eq)
+                      Equal&& eq,
+                      size_t threads = 1)
 {
     return hirschberg::trace(
         first1,
@@ -69,7 +95,8 @@ OutputIt intersection(RandomIt1 first1,
         first2,
         last2,
         result,
-        detail::dynamic_programming<Equal>{std::forward<Equal>(eq)});
+        detail::dynamic_programming<Equal>{std::forward<Equal>(eq)},
+        threads);
 }
 
 template <class RandomIt1, class RandomIt2, class OutputIt>
@@ -87,14 +114,16 @@ template <class RandomRng1, class RandomRng2, class OutputIt, class Equal>
 OutputIt intersection(const RandomRng1& rng1,
                       const RandomRng2& rng2,
                       OutputIt result,
-                      Equal&& eq)
+                      Equal&& eq,
+                      size_t threads = 1)
 {
     return longest_common_subsequence::intersection(std::begin(rng1),
                                                     std::end(rng1),
                                                     std::begin(rng2),
                                                     std::end(rng2),
                                                     result,
-                                                    std::forward<Equal>(eq));
+                                                    std::forward<Equal>(eq),
+                                                    threads);
 }
 
 template <class RandomRng1, class RandomRng2, class OutputIt>
@@ -109,6 +138,138 @@ OutputIt intersection(const RandomRng1& rng1,
                                                     result);
 }
 
+/// Same, but the rows are taken from the workspace.
+
+/// No memory is allocated, once the workspace has grown for the inputs
+/// of this size.
+/// @param ws - to reuse between the calls, but not between the threads.
+template <class RandomIt1, class RandomIt2, class OutputIt, class Equal>
+OutputIt intersection(RandomIt1 first1,
+                      RandomIt1 last1,
+                      RandomIt2 first2,
+                      RandomIt2 last2,
+                      OutputIt result,
+                      Equal&& eq,
+                      workspace& ws)
+{
+    return hirschberg::trace(
+        first1,
+        last1,
+        first2,
+        last2,
+        result,
+        detail::dynamic_programming<Equal>{std::forward<Equal>(eq)},
+        ws);
+}
+
+template <class RandomRng1, class RandomRng2, class OutputIt, class Equal>
+OutputIt intersection(const RandomRng1& rng1,
+                      const RandomRng2& rng2,
+                      OutputIt result,
+                      Equal&& eq,
+                      workspace& ws)
+{
+    return longest_common_subsequence::intersection(std::begin(rng1),
+                                                    std::end(rng1),
+                                                    std::begin(rng2),
+                                                    std::end(rng2),
+                                                    result,
+                                                    std::forward<Equal>(eq),
+                                                    ws);
+}
+
+/// Find a common subsequence, divided on the elements that occur once
+/// in each sequence.
+
+/// Unique elements are matched as in patience diff, and the gaps between
+/// them are traced independently. It is faster on large inputs like lines
+/// of files, but the subsequence is not necessarily the longest.
+/// Elements are compared with operator== and grouped by std::hash.
+template <class RandomIt1, class RandomIt2, class OutputIt>
+OutputIt anchored_intersection(RandomIt1 first1,
+                               RandomIt1 last1,
+                               RandomIt2 first2,
+                               RandomIt2 last2,
+                               OutputIt result)
+{
+    return hirschberg::anchored_trace(
+        first1,
+        last1,
+        first2,
+        last2,
+        result,
+        detail::dynamic_programming<std::equal_to<>>{});
+}
+
+template <class RandomRng1, class RandomRng2, class OutputIt>
+OutputIt anchored_intersection(const RandomRng1& rng1,
+                               const RandomRng2& rng2,
+                               OutputIt result)
+{
+    return longest_common_subsequence::anchored_intersection(std::begin(rng1),
+                                                             std::end(rng1),
+                                                             std::begin(rng2),
+                                                             std::end(rng2),
+                                                             result);
+}
+
+/// Find the longest subsequence present in two similar sequences.
+
+/// Myers' greedy algorithm with linear space refinement:
+/// the running time depends on the size of the difference
+/// rather than the product of the lengths.
+/// Time complexity O((N+M)*D), space complexity O(N+M), where:
+/// N = std::distance(first1, last1), M = std::distance(first2, last2),
+/// D - number of elements that are not in the subsequence.
+/// @see https://en.wikipedia.org/wiki/Diff#Algorithm
+template <class RandomIt1, class RandomIt2, class OutputIt, class Equal>
+OutputIt myers_intersection(RandomIt1 first1,
+                            RandomIt1 last1,
+                            RandomIt2 first2,
+                            RandomIt2 last2,
+                            OutputIt result,
+                            const Equal& eq)
+{
+    return myers::trace(first1, last1, first2, last2, result, eq);
+}
+
+template <class RandomIt1, class RandomIt2, class OutputIt>
+OutputIt myers_intersection(RandomIt1 first1,
+                            RandomIt1 last1,
+                            RandomIt2 first2,
+                            RandomIt2 last2,
+                            OutputIt result)
+{
+    return longest_common_subsequence::myers_intersection(
+        first1, last1, first2, last2, result, std::equal_to{});
+}
+
+template <class RandomRng1, class RandomRng2, class OutputIt, class Equal>
+OutputIt myers_intersection(const RandomRng1& rng1,
+                            const RandomRng2& rng2,
+                            OutputIt result,
+                            const Equal& eq)
+{
+    return longest_common_subsequence::myers_intersection(std::begin(rng1),
+                                                          std::end(rng1),
+                                                          std::begin(rng2),
+                                                          std::end(rng2),
+                                                          result,
+                                                          eq);
+}
+
+template <class RandomRng1, class RandomRng2, class OutputIt>
+OutputIt myers_intersection(const RandomRng1& rng1,
+                            const RandomRng2& rng2,
+                            OutputIt result)
+{
+    return longest_common_subsequence::myers_intersection(std::begin(rng1),
+                                                          std::end(rng1),
+                                                          std::begin(rng2),
+                                                          std::end(rng2),
+                                                          result);
+}
+
 }  // namespace step::longest_common_subsequence
 
 #endif  // STEP_LONGEST_COMMON_SUBSEQUENCE_HPP
@@ -0,0 +1,140 @@
+// Andrew Naplavkov
+
+#ifndef STEP_MAPPED_SUFFIX_ARRAY_HPP
+#define STEP_MAPPED_SUFFIX_ARRAY_HPP
+
+#include "detail/mapped_file.hpp"
+#include "suffix_array.hpp"
+#include <cstring>
+#include <stdexcept>
+
+namespace step {
+namespace detail {
+
+/// Header, text, suffix array, optional LCP and LCP-LR arrays.
+
+/// Sections are 8-byte aligned, integers are in native byte order.
+struct suffix_array_header {
+    static constexpr uint32_t signature = 0x41535453;  // "STSA"
+    static constexpr uint32_t current_version = 2;
+    static constexpr uint8_t with_lcp = 1;
+    static constexpr uint8_t with_lcp_lr = 2;  ///< since version 2
+
+    uint32_t magic;
+    uint32_t version;
+    uint8_t value_size;
+    uint8_t size_size;
+    uint8_t flags;
+    uint8_t reserved[5];
+    uint64_t length;
+};
+
+}  // namespace detail
+
+/// Write the suffix array in the format of mapped_suffix_array.
+
+/// @param lcp - to store the longest common prefix array too,
+/// along with LCP-LR array for the accelerated search.
+template <class T, class Size, class Compare>
+void save(const suffix_array_view<T, Size, Compare>& arr,
+          std::ostream& os,
+          bool lcp = false)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    auto head = detail::suffix_array_header{
+        detail::suffix_array_header::signature,
+        detail::suffix_array_header::current_version,
+        sizeof(T),
+        sizeof(Size),
+        lcp ? uint8_t(detail::suffix_array_header::with_lcp |
+                      detail::suffix_array_header::with_lcp_lr)
+            : uint8_t{},
+        {},
+        arr.size()};
+    detail::write(os, &head, 1);
+    detail::write(os, arr.data(), arr.size());
+    std::vector<Size> buf(arr.size());
+    for (Size i = 0; i < arr.size(); ++i)
+        buf[i] = arr.nth_element(i);
+    detail::write(os, buf.data(), buf.size());
+    if (lcp) {
+        arr.longest_common_prefix_array(buf.begin());
+        detail::write(os, buf.data(), buf.size());
+        std::vector<Size> lcp_lr(2 * buf.size());
+        detail::fill_lcp_lr<Size>(buf, 0, buf.size() + 1, lcp_lr);
+        detail::write(os, lcp_lr.data(), lcp_lr.size());
+    }
+}
+
+template <class T, class Size, class Compare>
+void save(const suffix_array<T, Size, Compare>& arr,
+          std::ostream& os,
+          bool lcp = false)
+{
+    save(suffix_array_view<T, Size, Compare>{arr}, os, lcp);
+}
+
+/// Read-only suffix array in a memory-mapped file written by save().
+
+/// Opening does not depend on the text length, pages are loaded on demand.
+/// The file shall be written with the same T, Size and Compare.
+template <class T = char, class Size = size_t, class Compare = std::less<>>
+class mapped_suffix_array : public suffix_array_view<T, Size, Compare> {
+    using base_type = suffix_array_view<T, Size, Compare>;
+
+public:
+    explicit mapped_suffix_array(const char* path) : file_{path}
+    {
+        auto head = detail::suffix_array_header{};
+        if (file_.size() < sizeof head)
+            invalid();
+        std::memcpy(&head, file_.data(), sizeof head);
+        if (head.magic != head.signature ||
+            !head.version || head.version > head.current_version ||
+            head.value_size != sizeof(T) || head.size_size != sizeof(Size) ||
+            head.length > std::numeric_limits<Size>::max())
+            invalid();
+        size_t offset = sizeof head;
+        auto str = section<T>(offset, head.length);
+        auto idx = section<Size>(offset, head.length);
+        auto lcp_lr = span<const Size>{};
+        if (head.flags & head.with_lcp)
+            lcp_ = section<Size>(offset, head.length);
+        if (head.flags & head.with_lcp_lr)
+            lcp_lr = section<Size>(offset, 2 * head.length);
+        static_cast<base_type&>(*this) = base_type{str, idx, lcp_lr};
+    }
+
+    /// Copy the stored array or construct it if missing
+    template <class RandomIt>
+    void longest_common_prefix_array(RandomIt result) const
+    {
+        if (lcp_.data())
+            std::copy(lcp_.begin(), lcp_.end(), result);
+        else
+            base_type::longest_common_prefix_array(result);
+    }
+
+private:
+    mapped_file file_;
+    span<const Size> lcp_;
+
+    template <class U>
+    span<const U> section(size_t& offset, size_t count) const
+    {
+        auto first = offset;
+        offset += detail::align(count * sizeof(U));
+        if (offset > file_.size())
+            invalid();
+        return {(const U*)(file_.data() + first), count};
+    }
+
+    [[noreturn]] static void invalid()
+    {
+        throw std::runtime_error("step::mapped_suffix_array: invalid file");
+    }
+};
+
+}  // namespace step
+
+#endif  // STEP_MAPPED_SUFFIX_ARRAY_HPP
@@ -0,0 +1,343 @@
+// Andrew Naplavkov
+
+#ifndef STEP_MAPPED_SUFFIX_TREE_HPP
+#define STEP_MAPPED_SUFFIX_TREE_HPP
+
+#include "detail/mapped_file.hpp"
+#include "suffix_tree.hpp"
+#include <cstring>
+#include <stdexcept>
+
+namespace step {
+namespace detail {
+
+/// Header, text, ranges and links of inner nodes, edges of inner nodes.
+
+/// Sections are 8-byte aligned, integers are in native byte order.
+/// Edges are grouped by the parent node and sorted by the first character,
+/// leaves are flipped offsets of the text as in suffix_tree.
+struct suffix_tree_header {
+    static constexpr uint32_t signature = 0x54535453;  // "STST"
+    static constexpr uint32_t current_version = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint8_t value_size;
+    uint8_t size_size;
+    uint8_t reserved[6];
+    uint64_t length;  ///< popped characters included
+    uint64_t front;   ///< number of popped characters
+    uint64_t active_char;
+    uint64_t active_node;
+    uint64_t nodes;
+    uint64_t edges;
+};
+
+struct suffix_tree_access {
+    template <class Compare, class Tree>
+    static void save(const Tree& tree, std::ostream& os)
+    {
+        using value_t = typename Tree::value_type;
+        using size_t_ = typename Tree::size_type;
+        static_assert(std::is_trivially_copyable_v<value_t>);
+        static_assert(std::is_trivially_copyable_v<size_t_>);
+        auto ranges = std::vector<size_t_>{};
+        auto links = std::vector<size_t_>{};
+        auto offsets = std::vector<uint64_t>{0};
+        auto edges = std::vector<std::pair<value_t, size_t_>>{};
+        for (auto& node : tree.nodes_) {
+            ranges.push_back(node.rng.first);
+            ranges.push_back(node.rng.second);
+            links.push_back(node.link);
+            auto first = edges.size();
+            edges.insert(
+                edges.end(), node.children.begin(), node.children.end());
+            std::sort(edges.begin() + first,
+                      edges.end(),
+                      [cmp = Compare{}](auto& lhs, auto& rhs) {
+                          return cmp(lhs.first, rhs.first);
+                      });
+            offsets.push_back(edges.size());
+        }
+        auto head = suffix_tree_header{suffix_tree_header::signature,
+                                       suffix_tree_header::current_version,
+                                       sizeof(value_t),
+                                       sizeof(size_t_),
+                                       {},
+                                       tree.str_.size(),
+                                       tree.front_,
+                                       tree.char_,
+                                       tree.node_,
+                                       tree.nodes_.size(),
+                                       edges.size()};
+        write(os, &head, 1);
+        write(os, tree.str_.data(), tree.str_.size());
+        write(os, ranges.data(), ranges.size());
+        write(os, links.data(), links.size());
+        write(os, offsets.data(), offsets.size());
+        auto keys = std::vector<value_t>(edges.size());
+        auto children = std::vector<size_t_>(edges.size());
+        for (size_t i = 0; i < edges.size(); ++i)
+            std::tie(keys[i], children[i]) = edges[i];
+        write(os, keys.data(), keys.size());
+        write(os, children.data(), children.size());
+    }
+
+    template <class Mapped, class Tree>
+    static void load(const Mapped& src, Tree& dest)
+    try {
+        auto& head = src.head_;
+        dest.clear();
+        dest.str_.assign(src.str_.begin(), src.str_.end());
+        dest.nodes_.reserve(head.nodes);
+        for (size_t i = 0; i < head.nodes; ++i) {
+            auto children = dest.make_map();
+            for (auto j = src.offsets_[i]; j < src.offsets_[i + 1]; ++j)
+                children[src.keys_[j]] = src.children_[j];
+            if (i && children.empty())
+                dest.free_.push_back(i);
+            auto rng = std::pair{src.ranges_[2 * i], src.ranges_[2 * i + 1]};
+            dest.nodes_.push_back({std::move(children), rng, src.links_[i]});
+        }
+        dest.front_ = head.front;
+        dest.char_ = head.active_char;
+        dest.node_ = head.active_node;
+    }
+    catch (...) {
+        dest.clear();
+        throw;
+    }
+};
+
+}  // namespace detail
+
+/// Write the suffix tree in the format of mapped_suffix_tree.
+
+/// The active point is stored too, so push_back can be resumed after load.
+/// @tparam Compare - to sort the edges, it shall agree with the Map.
+template <class Compare = std::less<>,
+          class T,
+          class Size,
+          template <class...>
+          class Map,
+          class Allocator>
+void save(const suffix_tree<T, Size, Map, Allocator>& tree, std::ostream& os)
+{
+    detail::suffix_tree_access::save<Compare>(tree, os);
+}
+
+/// Read-only suffix tree in a memory-mapped file written by save().
+
+/// Opening does not depend on the text length, pages are loaded on demand.
+/// Children are found by binary search, so lookups take O(log(K)) time,
+/// where: K - alphabet size.
+/// The file shall be written with the same T, Size and Compare.
+template <class T = char, class Size = size_t, class Compare = std::less<>>
+class mapped_suffix_tree {
+public:
+    using value_type = T;
+    using size_type = Size;
+    using substring = std::pair<Size, Size>;  ///< half-open offset range
+
+    explicit mapped_suffix_tree(const char* path) : file_{path}
+    {
+        if (file_.size() < sizeof head_)
+            invalid();
+        std::memcpy(&head_, file_.data(), sizeof head_);
+        if (head_.magic != head_.signature || !head_.version ||
+            head_.version > head_.current_version ||
+            head_.value_size != sizeof(T) || head_.size_size != sizeof(Size) ||
+            head_.length > std::numeric_limits<Size>::max() ||
+            head_.front > head_.length || head_.nodes > head_.length + 1 ||
+            (head_.nodes && head_.active_node >= head_.nodes))
+            invalid();
+        size_t offset = sizeof head_;
+        str_ = section<T>(offset, head_.length);
+        ranges_ = section<Size>(offset, 2 * head_.nodes);
+        links_ = section<Size>(offset, head_.nodes);
+        offsets_ = section<uint64_t>(offset, head_.nodes + 1);
+        keys_ = section<T>(offset, head_.edges);
+        children_ = section<Size>(offset, head_.edges);
+        if (offsets_[0] || offsets_[head_.nodes] != head_.edges ||
+            !std::is_sorted(offsets_.begin(), offsets_.end()))
+            invalid();
+    }
+
+    const T* data() const { return str_.data() + head_.front; }
+    Size size() const { return Size(head_.length - head_.front); }
+
+    /// @see suffix_tree::find
+    template <class InputIt>
+    Size find(InputIt first, InputIt last) const
+    {
+        auto edge = find_edge(first, last);
+        return edge ? path(*edge).first : size();
+    }
+
+    template <class InputRng>
+    Size find(const InputRng& rng) const
+    {
+        return find(std::begin(rng), std::end(rng));
+    }
+
+    /// @see suffix_tree::find_all
+    template <class InputIt, class OutputIt>
+    OutputIt find_all(InputIt first, InputIt last, OutputIt result) const
+    {
+        if (auto src = find_edge(first, last))
+            dfs(*src, [&](auto& edge) {
+                if (leaf(edge.child))
+                    *result++ = path(edge).first;
+            });
+        return result;
+    }
+
+    template <class InputRng, class OutputIt>
+    OutputIt find_all(const InputRng& rng, OutputIt result) const
+    {
+        return find_all(std::begin(rng), std::end(rng), result);
+    }
+
+    /// @see suffix_tree::visited_edge
+    struct visited_edge {
+        Size parent;
+        Size child;
+        Size path;
+        bool visited;
+    };
+
+    /// @see suffix_tree::visit
+    template <class Visitor>
+    void visit(Visitor&& viz) const
+    {
+        if (nodes())
+            dfs({}, std::forward<Visitor>(viz));
+    }
+
+    bool leaf(Size node) const { return node >= nodes(); }
+
+    substring substr(Size node) const
+    {
+        auto [first, last] = range(node);
+        return {Size(first - head_.front), Size(last - head_.front)};
+    }
+
+    substring path(const visited_edge& edge) const
+    {
+        Size last = substr(edge.child).second;
+        return {Size(last - edge.path), last};
+    }
+
+private:
+    friend detail::suffix_tree_access;
+
+    inline static const auto eq_ = equivalence<Compare>{};
+    inline static const auto cmp_ = Compare{};
+
+    mapped_file file_;
+    detail::suffix_tree_header head_{};
+    span<const T> str_;
+    span<const Size> ranges_;
+    span<const Size> links_;
+    span<const uint64_t> offsets_;
+    span<const T> keys_;
+    span<const Size> children_;
+
+    Size nodes() const { return Size(head_.nodes); }
+
+    substring range(Size node) const
+    {
+        return leaf(node) ? substring{flip(node), Size(head_.length)}
+                          : substring{ranges_[2 * node], ranges_[2 * node + 1]};
+    }
+
+    template <class U>
+    span<const U> section(size_t& offset, size_t count) const
+    {
+        auto first = offset;
+        offset += detail::align(count * sizeof(U));
+        if (offset > file_.size())
+            invalid();
+        return {(const U*)(file_.data() + first), count};
+    }
+
+    [[noreturn]] static void invalid()
+    {
+        throw std::runtime_error("step::mapped_suffix_tree: invalid file");
+    }
+
+    template <class Key>
+    std::optional<Size> find_child(Size node, const Key& key) const
+    {
+        auto first = keys_.begin() + offsets_[node];
+        auto last = keys_.begin() + offsets_[node + 1];
+        auto it = std::lower_bound(first, last, key, cmp_);
+        if (it == last || cmp_(key, *it))
+            return std::nullopt;
+        return children_[it - keys_.begin()];
+    }
+
+    template <class InputIt>
+    std::optional<visited_edge> find_edge(InputIt first, InputIt last) const
+    {
+        for (visited_edge edge{}; nodes();) {
+            auto rng = substr(edge.child);
+            edge.path += step::size(rng);
+            auto diff = std::mismatch(
+                first, last, data() + rng.first, data() + rng.second, eq_);
+            if (diff.first == last)
+                return edge;
+            if (diff.second != data() + rng.second || leaf(edge.child))
+                break;
+            auto child = find_child(edge.child, *diff.first);
+            if (!child)
+                break;
+            first = diff.first;
+            edge.parent = std::exchange(edge.child, *child);
+        }
+        return std::nullopt;
+    }
+
+    void spawn(visited_edge src, std::stack<visited_edge>& dest) const
+    {
+        for (auto i = offsets_[src.child]; i < offsets_[src.child + 1]; ++i) {
+            Size child = children_[i];
+            dest.push({src.child,
+                       child,
+                       Size(src.path + step::size(substr(child))),
+                       false});
+        }
+    }
+
+    template <class Visitor>
+    void dfs(const visited_edge& src, Visitor viz) const
+    {
+        for (std::stack<visited_edge> stack{{src}}; !stack.empty();) {
+            auto& top = stack.top();
+            viz(std::as_const(top));
+            if (leaf(top.child) || std::exchange(top.visited, true))
+                stack.pop();
+            else
+                spawn(top, stack);
+        }
+    }
+};
+
+/// Read the tree written by save() to resume push_back or pop_front.
+
+/// Basic exception guarantee
+template <class T,
+          class Size,
+          class Compare,
+          template <class...>
+          class Map,
+          class Allocator>
+void load(const mapped_suffix_tree<T, Size, Compare>& src,
+          suffix_tree<T, Size, Map, Allocator>& dest)
+{
+    detail::suffix_tree_access::load(src, dest);
+}
+
+}  // namespace step
+
+#endif  // STEP_MAPPED_SUFFIX_TREE_HPP
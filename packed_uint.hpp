@@ -0,0 +1,89 @@
+// Andrew Naplavkov
+
+#ifndef STEP_PACKED_UINT_HPP
+#define STEP_PACKED_UINT_HPP
+
+#include "detail/utility.hpp"
+
+namespace step {
+
+/// Unsigned integer of N bytes without alignment.
+
+/// It is stored little-endian and computed as uint64_t, so it can be
+/// the Size of step::suffix_tree for texts between 4GB and 1TB:
+/// offsets, links and child ids take five bytes instead of eight.
+/// @code
+/// step::suffix_tree<char, step::uint40_t, step::flat_map> tree{};
+/// @endcode
+template <size_t N>
+class packed_uint {
+    static_assert(N > 0 && N < sizeof(uint64_t));
+    uint8_t bytes_[N] = {};
+
+public:
+    constexpr packed_uint() = default;
+
+    constexpr packed_uint(uint64_t val)
+    {
+        for (size_t i = 0; i < N; ++i)
+            bytes_[i] = uint8_t(val >> 8 * i);
+    }
+
+    constexpr operator uint64_t() const
+    {
+        uint64_t res = 0;
+        for (size_t i = 0; i < N; ++i)
+            res |= uint64_t(bytes_[i]) << 8 * i;
+        return res;
+    }
+
+    constexpr packed_uint& operator+=(uint64_t val)
+    {
+        return *this = *this + val;
+    }
+
+    constexpr packed_uint& operator-=(uint64_t val)
+    {
+        return *this = *this - val;
+    }
+
+    constexpr packed_uint& operator++() { return *this += 1; }
+    constexpr packed_uint& operator--() { return *this -= 1; }
+
+    packed_uint operator++(int)
+    {
+        return std::exchange(*this, *this + 1);
+    }
+
+    packed_uint operator--(int)
+    {
+        return std::exchange(*this, *this - 1);
+    }
+};
+
+using uint40_t = packed_uint<5>;
+
+template <size_t N>
+packed_uint<N> flip(packed_uint<N> n)
+{
+    return std::numeric_limits<packed_uint<N>>::max() - n;
+}
+
+}  // namespace step
+
+template <size_t N>
+struct std::numeric_limits<step::packed_uint<N>>
+    : std::numeric_limits<uint64_t> {
+    static constexpr int digits = 8 * N;
+    static constexpr int digits10 = digits * 3 / 10;
+
+    static constexpr step::packed_uint<N> min() noexcept { return 0; }
+    static constexpr step::packed_uint<N> lowest() noexcept { return 0; }
+
+    static constexpr step::packed_uint<N> max() noexcept
+    {
+        return (uint64_t{1} << digits) - 1;
+    }
+};
+
+#endif  // STEP_PACKED_UINT_HPP
@@ -3,78 +3,85 @@
 #ifndef STEP_SUFFIX_ARRAY_HPP
 #define STEP_SUFFIX_ARRAY_HPP
 
-#include "detail/utility.hpp"
+#include "detail/induced_sorting.hpp"
+#include "detail/parallel.hpp"
+#include "detail/prefix_doubling.hpp"
+#include <cstring>
 
 namespace step {
+namespace detail {
 
-/// Manber's algorithm for constructing suffix array.
+/// Fill LCP-LR array for the binary search in (lo, hi).
+
+/// Fences 0 and N+1 are virtual bounds, fence i is the (i-1)-th suffix.
+/// result[2*(mid-1)] and result[2*mid-1] receive the longest common prefixes
+/// of the middle suffix with the suffixes at the lower and upper fences.
+/// @return the longest common prefix of the suffixes at the fences.
+template <class Size>
+Size fill_lcp_lr(span<const Size> lcp, size_t lo, size_t hi, span<Size> result)
+{
+    if (hi - lo == 1)
+        return lo && hi <= lcp.size() ? lcp[lo - 1] : Size{};
+    size_t mid = (lo + hi) / 2;
+    auto llcp = result[2 * (mid - 1)] = fill_lcp_lr(lcp, lo, mid, result);
+    auto rlcp = result[2 * mid - 1] = fill_lcp_lr(lcp, mid, hi, result);
+    return std::min(llcp, rlcp);
+}
+
+}  // namespace detail
+
+/// Non-owning read-only suffix array.
 
-/// Time complexity O(N*log(N)*log(N)), space complexity O(N), where:
-/// N - text length.
 /// @param T - type of the characters;
 /// @param Size - to specify the maximum number / offset of characters;
 /// @param Compare - to determine the order of characters.
-/// @see https://en.wikipedia.org/wiki/Suffix_array
 template <class T = char, class Size = size_t, class Compare = std::less<>>
-class suffix_array {
+class suffix_array_view {
 public:
     using value_type = T;
     using size_type = Size;
 
-    auto data() const { return str_.data(); }
-    Size size() const { return (Size)str_.size(); }
-
-    /// Return offset of the n-th suffix in lexicographical order
-    Size nth_element(Size nth) const { return idx_[nth]; }
+    constexpr suffix_array_view() = default;
 
-    template <class InputIt>
-    suffix_array(InputIt first, InputIt last)
-        : suffix_array(std::vector<T>(first, last))
+    /// @param idx - offsets of the suffixes of str in lexicographical order;
+    /// @param lcp_lr - optional array to speed up the search.
+    /// @see detail::fill_lcp_lr
+    constexpr suffix_array_view(span<const T> str,
+                                span<const Size> idx,
+                                span<const Size> lcp_lr = {})
+        : str_{str}, idx_{idx}, lcp_lr_{lcp_lr}
     {
     }
 
-    template <class InputRng>
-    explicit suffix_array(const InputRng& rng)
-        : suffix_array(std::begin(rng), std::end(rng))
-    {
-    }
+    auto data() const { return str_.data(); }
+    Size size() const { return (Size)str_.size(); }
 
-    explicit suffix_array(std::vector<T>&& str)
-        : str_(std::move(str)), idx_(size())
-    {
-        auto generator = [i = Size{}]() mutable { return suffix{i++, {}}; };
-        auto pos = [](auto& suf) { return suf.pos; };
-        auto val = [&](auto& suf) { return str_[suf.pos]; };
-        auto by_rank = [](auto& l, auto& r) { return l.rank < r.rank; };
-        auto by_val = [&](auto& l, auto& r) { return cmp_(val(l), val(r)); };
-
-        std::vector<suffix> sufs(size());
-        std::generate(sufs.begin(), sufs.end(), generator);
-        std::sort(sufs.begin(), sufs.end(), by_val);
-        fill_first_rank(sufs, by_val);
-        for (Size shift = 1; !sorted(sufs); shift *= 2) {
-            fill_second_rank(sufs, shift);
-            std::sort(sufs.begin(), sufs.end(), by_rank);
-            fill_first_rank(sufs, by_rank);
-        }
-        std::transform(sufs.begin(), sufs.end(), idx_.begin(), pos);
-    }
+    /// Return offset of the n-th suffix in lexicographical order
+    Size nth_element(Size nth) const { return idx_[nth]; }
 
     /// Find all occurrences of the substring.
 
-    /// Time complexity O(M*log(N)), where:
+    /// Time complexity O(M*log(N)), or O(M+log(N)) with LCP-LR array, where:
     /// M - substring length, N - text length.
     /// @return pair of offset iterators.
     template <class InputIt>
     auto find_all(InputIt first, InputIt last) const
     {
+        using category =
+            typename std::iterator_traits<InputIt>::iterator_category;
+        if (lcp_lr_.size()) {
+            if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
+                                            category>)
+                return std::make_pair(idx_.begin() + bound(first, last, false),
+                                      idx_.begin() + bound(first, last, true));
+            else {
+                auto pattern = std::vector<T>(first, last);
+                return find_all(pattern.begin(), pattern.end());
+            }
+        }
         auto result = std::make_pair(idx_.begin(), idx_.end());
         std::for_each(first, last, [&, i = Size{}](T val) mutable {
-            auto at = shifted_value_or(i++, val);
-            result = std::equal_range(
-                result.first, result.second, size(), [&](Size l, Size r) {
-                    return cmp_(at(str_, l), at(str_, r));
-                });
+            result = narrow(result, i++, val);
         });
         return result;
     }
@@ -85,6 +92,46 @@ public:
         return find_all(std::begin(rng), std::end(rng));
     }
 
+    /// Find all occurrences of every substring.
+
+    /// Substrings are sorted, so neighbours share the search
+    /// for their common prefix.
+    /// @param first, last - random access range of random access ranges;
+    /// @param result - receives pairs of substring index
+    /// and pair of offset iterators in the order of substrings;
+    /// @param threads - to split the sorted substrings between.
+    template <class RandomIt, class OutputIt>
+    OutputIt find_all_batch(RandomIt first,
+                            RandomIt last,
+                            OutputIt result,
+                            size_t threads = 1) const
+    {
+        auto less = [&](size_t l, size_t r) {
+            return std::lexicographical_compare(std::begin(first[l]),
+                                                std::end(first[l]),
+                                                std::begin(first[r]),
+                                                std::end(first[r]),
+                                                cmp_);
+        };
+        std::vector<size_t> order(std::distance(first, last));
+        std::iota(order.begin(), order.end(), size_t{});
+        parallel::sort(order.begin(), order.end(), less, threads);
+        if (threads < 2)
+            return narrow_batch(first, order.begin(), order.end(), result);
+        using value_t = std::pair<size_t, decltype(find_all(*first))>;
+        std::vector<std::vector<value_t>> chunks(threads);
+        parallel::for_each_chunk(
+            threads, order.size(), [&](size_t chunk, size_t from, size_t to) {
+                narrow_batch(first,
+                             order.begin() + from,
+                             order.begin() + to,
+                             std::back_inserter(chunks[chunk]));
+            });
+        for (auto& chunk : chunks)
+            result = std::copy(chunk.begin(), chunk.end(), result);
+        return result;
+    }
+
     /// Find offset of the substring
     template <class InputIt>
     Size find(InputIt first, InputIt last) const
@@ -99,30 +146,41 @@ public:
         return find(std::begin(rng), std::end(rng));
     }
 
-    /// Kasai's algorithm for constructing longest common prefix array.
+    /// Construct longest common prefix array.
 
+    /// result[i] receives the longest common prefix of the i-th suffix
+    /// and the next one in lexicographical order.
     /// Time and space complexity O(N), where: N - text length.
     /// @see https://en.wikipedia.org/wiki/LCP_array
     template <class RandomIt>
     void longest_common_prefix_array(RandomIt result) const
     {
-        std::vector<Size> inverse(size());
+        std::vector<Size> plcp(size());
+        permuted_longest_common_prefix_array(plcp.begin());
+        for (Size i = 0; i < size(); ++i)
+            result[i] = plcp[idx_[i]];
+    }
+
+    /// Karkkainen's PHI algorithm for permuted longest common prefix array.
+
+    /// result[pos] receives the longest common prefix of the suffix at pos
+    /// and the next one in lexicographical order.
+    /// The result is used as PHI array first, so no extra memory is required.
+    /// Suffixes are compared in text order, that is cache-friendly.
+    /// Time complexity O(N), where: N - text length.
+    /// @see https://doi.org/10.1007/978-3-642-02441-2_17
+    template <class RandomIt>
+    void permuted_longest_common_prefix_array(RandomIt result) const
+    {
         for (Size i = 0; i < size(); ++i)
-            inverse[idx_[i]] = i;
+            result[idx_[i]] = i + 1 < size() ? idx_[i + 1] : size();
         for (Size pos = 0, lcp = 0; pos < size(); ++pos) {
-            Size cur = inverse[pos];
-            Size next = cur + 1;
-            if (next < size()) {
-                auto diff = std::mismatch(str_.begin() + pos + lcp,
-                                          str_.end(),
-                                          str_.begin() + idx_[next] + lcp,
-                                          str_.end(),
-                                          eq_);
-                lcp = (Size)std::distance(str_.begin() + pos, diff.first);
-            }
+            Size next = result[pos];
+            if (next < size())
+                lcp += common_prefix_length(pos + lcp, next + lcp);
             else
                 lcp = 0;
-            result[cur] = lcp;
+            result[pos] = lcp;
             if (lcp)
                 --lcp;
         }
@@ -132,42 +190,242 @@ private:
     inline static const auto cmp_ = Compare{};
     inline static const auto eq_ = equivalence<Compare>{};
 
-    std::vector<T> str_;
-    std::vector<Size> idx_;
+    span<const T> str_;
+    span<const Size> idx_;
+    span<const Size> lcp_lr_;
 
-    struct suffix {
-        Size pos;
-        std::pair<Size, Size> rank;
-    };
+    /// Longest common prefix of the suffixes, a word at a time for bytes
+    Size common_prefix_length(Size lhs, Size rhs) const
+    {
+        size_t len = size() - std::max(lhs, rhs), i = 0;
+        if constexpr (sizeof(T) == 1 && std::is_trivially_copyable_v<T> &&
+                      (std::is_same_v<Compare, std::less<>> ||
+                       std::is_same_v<Compare, std::less<T>>)) {
+            for (uint64_t l, r; i + sizeof l <= len; i += sizeof l) {
+                std::memcpy(&l, str_.data() + lhs + i, sizeof l);
+                std::memcpy(&r, str_.data() + rhs + i, sizeof r);
+                if (l != r)
+                    break;
+            }
+        }
+        while (i < len && eq_(str_[lhs + i], str_[rhs + i]))
+            ++i;
+        return (Size)i;
+    }
 
-    template <class Cmp>
-    static void fill_first_rank(std::vector<suffix>& sufs, Cmp cmp)
+    template <class It>
+    auto narrow(std::pair<It, It> rng, Size shift, T val) const
     {
-        Size uniq = 1;
-        for (size_t i = 1; i < sufs.size(); ++i) {
-            bool less = cmp(sufs[i - 1], sufs[i]);
-            sufs[i - 1].rank.first = uniq;
-            if (less)
-                ++uniq;
+        // size() is the key, shorter suffixes precede it
+        return std::equal_range(
+            rng.first, rng.second, size(), [&](Size l, Size r) {
+                if (r == size())
+                    return l + shift >= size() || cmp_(str_[l + shift], val);
+                return r + shift < size() && cmp_(val, str_[r + shift]);
+            });
+    }
+
+    template <class RandomIt, class IndexIt, class OutputIt>
+    OutputIt narrow_batch(RandomIt patterns,
+                          IndexIt first,
+                          IndexIt last,
+                          OutputIt result) const
+    {
+        // ranges[i] is narrowed by the first i characters
+        std::vector<std::pair<const Size*, const Size*>> ranges{
+            {idx_.begin(), idx_.end()}};
+        for (auto prev = first; first != last; prev = first++) {
+            auto& cur = patterns[*first];
+            size_t len = std::distance(std::begin(cur), std::end(cur));
+            size_t common = 0;
+            if (prev != first) {
+                auto& pre = patterns[*prev];
+                auto diff = std::mismatch(std::begin(pre),
+                                          std::end(pre),
+                                          std::begin(cur),
+                                          std::end(cur),
+                                          eq_);
+                common = std::distance(std::begin(pre), diff.first);
+            }
+            ranges.resize(common + 1);
+            for (size_t i = common; i < len; ++i)
+                ranges.push_back(
+                    narrow(ranges.back(), (Size)i, std::begin(cur)[i]));
+            *result++ = std::make_pair(*first, ranges.back());
         }
-        if (!sufs.empty())
-            sufs.back().rank.first = uniq;
+        return result;
     }
 
-    static void fill_second_rank(std::vector<suffix>& sufs, Size shift)
+    /// Manber-Myers binary search that keeps the matched prefix lengths
+    /// of the pattern with the suffixes at the fences: l and r.
+
+    /// @param upper - to skip the suffixes starting with the pattern.
+    /// @return the number of suffixes before the pattern.
+    template <class RandomIt>
+    size_t bound(RandomIt first, RandomIt last, bool upper) const
     {
-        std::vector<Size> ranks(sufs.size());
-        for (auto& suf : sufs)
-            ranks[suf.pos] = suf.rank.first;
-        auto at = shifted_value_or(shift, Size{});
-        for (auto& suf : sufs)
-            suf.rank.second = at(ranks, suf.pos);
+        size_t len = std::distance(first, last);
+        size_t lo = 0, hi = size() + size_t{1}, l = 0, r = 0;
+        while (hi - lo > 1) {
+            size_t mid = (lo + hi) / 2, m;
+            size_t llcp = lcp_lr_[2 * (mid - 1)], rlcp = lcp_lr_[2 * mid - 1];
+            bool right;  // the middle suffix is less than the pattern
+            if (l > r && llcp != l) {
+                right = llcp > l;
+                m = right ? l : llcp;
+            }
+            else if (r > l && rlcp != r) {
+                right = rlcp < r;
+                m = right ? rlcp : r;
+            }
+            else {
+                size_t pos = idx_[mid - 1];
+                m = std::max(l, r);
+                while (m < len && pos + m < size() &&
+                       eq_(first[m], str_[pos + m]))
+                    ++m;
+                if (m == len)
+                    right = upper;
+                else
+                    right = pos + m == size() || cmp_(str_[pos + m], first[m]);
+            }
+            right ? (lo = mid, l = m) : (hi = mid, r = m);
+        }
+        return lo;
     }
+};
+
+/// Sorted array of all suffixes of a text.
+
+/// Construction algorithm is chosen by the optional constructor parameter:
+/// prefix_doubling (Manber's, by default), radix_doubling or
+/// induced_sorting (SA-IS).
+/// Both produce the same order of suffixes.
+/// @param T - type of the characters;
+/// @param Size - to specify the maximum number / offset of characters;
+/// @param Compare - to determine the order of characters.
+/// @see https://en.wikipedia.org/wiki/Suffix_array
+template <class T = char, class Size = size_t, class Compare = std::less<>>
+class suffix_array {
+public:
+    using value_type = T;
+    using size_type = Size;
 
-    static bool sorted(const std::vector<suffix>& sufs)
+    auto data() const { return str_.data(); }
+    Size size() const { return (Size)str_.size(); }
+
+    /// Return offset of the n-th suffix in lexicographical order
+    Size nth_element(Size nth) const { return idx_[nth]; }
+
+    template <class InputIt>
+    suffix_array(InputIt first, InputIt last)
+        : suffix_array(std::vector<T>(first, last))
     {
-        return sufs.empty() || sufs.back().rank.first == (Size)sufs.size();
     }
+
+    template <class InputRng>
+    explicit suffix_array(const InputRng& rng)
+        : suffix_array(std::begin(rng), std::end(rng))
+    {
+    }
+
+    explicit suffix_array(std::vector<T>&& str)
+        : suffix_array(std::move(str), prefix_doubling{})
+    {
+    }
+
+    template <class InputIt, class Algorithm>
+    suffix_array(InputIt first, InputIt last, const Algorithm& algorithm)
+        : suffix_array(std::vector<T>(first, last), algorithm)
+    {
+    }
+
+    template <class InputRng, class Algorithm>
+    suffix_array(const InputRng& rng, const Algorithm& algorithm)
+        : suffix_array(std::begin(rng), std::end(rng), algorithm)
+    {
+    }
+
+    /// @param algorithm - prefix_doubling, radix_doubling or induced_sorting.
+    template <class Algorithm>
+    suffix_array(std::vector<T>&& str, const Algorithm& algorithm)
+        : str_(std::move(str)), idx_(size())
+    {
+        algorithm(str_, idx_, Compare{});
+    }
+
+    operator suffix_array_view<T, Size, Compare>() const
+    {
+        return {str_, idx_, lcp_lr_};
+    }
+
+    /// Build LCP-LR array to find substrings in O(M+log(N)) time.
+
+    /// Time and space complexity O(N).
+    void build_lcp_lr()
+    {
+        std::vector<Size> lcp(size());
+        longest_common_prefix_array(lcp.begin());
+        lcp_lr_.resize(2 * str_.size());
+        detail::fill_lcp_lr<Size>(lcp, 0, str_.size() + 1, lcp_lr_);
+    }
+
+    /// @see suffix_array_view::find_all
+    template <class InputIt>
+    auto find_all(InputIt first, InputIt last) const
+    {
+        return view().find_all(first, last);
+    }
+
+    template <class InputRng>
+    auto find_all(const InputRng& rng) const
+    {
+        return view().find_all(rng);
+    }
+
+    /// @see suffix_array_view::find_all_batch
+    template <class RandomIt, class OutputIt>
+    OutputIt find_all_batch(RandomIt first,
+                            RandomIt last,
+                            OutputIt result,
+                            size_t threads = 1) const
+    {
+        return view().find_all_batch(first, last, result, threads);
+    }
+
+    /// @see suffix_array_view::find
+    template <class InputIt>
+    Size find(InputIt first, InputIt last) const
+    {
+        return view().find(first, last);
+    }
+
+    template <class InputRng>
+    Size find(const InputRng& rng) const
+    {
+        return view().find(rng);
+    }
+
+    /// @see suffix_array_view::longest_common_prefix_array
+    template <class RandomIt>
+    void longest_common_prefix_array(RandomIt result) const
+    {
+        view().longest_common_prefix_array(result);
+    }
+
+    /// @see suffix_array_view::permuted_longest_common_prefix_array
+    template <class RandomIt>
+    void permuted_longest_common_prefix_array(RandomIt result) const
+    {
+        view().permuted_longest_common_prefix_array(result);
+    }
+
+private:
+    std::vector<T> str_;
+    std::vector<Size> idx_;
+    std::vector<Size> lcp_lr_;
+
+    suffix_array_view<T, Size, Compare> view() const { return *this; }
 };
 
 template <class InputIt>
@@ -176,6 +434,13 @@ suffix_array(InputIt, InputIt) -> suffix_array<iter_value_t<InputIt>>;
 template <class InputRng>
 suffix_array(InputRng) -> suffix_array<range_value_t<InputRng>>;
 
+template <class InputIt, class Algorithm>
+suffix_array(InputIt, InputIt, Algorithm)
+    -> suffix_array<iter_value_t<InputIt>>;
+
+template <class InputRng, class Algorithm>
+suffix_array(InputRng, Algorithm) -> suffix_array<range_value_t<InputRng>>;
+
 }  // namespace step
 
 #endif  // STEP_SUFFIX_ARRAY_HPP
@@ -3,12 +3,18 @@
 #ifndef STEP_SUFFIX_TREE_HPP
 #define STEP_SUFFIX_TREE_HPP
 
-#include "detail/utility.hpp"
+#include "suffix_array.hpp"
+#include <atomic>
 #include <optional>
 #include <stack>
 #include <unordered_map>
 
 namespace step {
+namespace detail {
+
+struct suffix_tree_access;
+
+}  // namespace detail
 
 /// Ukkonen's online algorithm for constructing suffix tree.
 
@@ -17,25 +23,72 @@ namespace step {
 /// @param T - type of the characters;
 /// @param Size - to specify the maximum number / offset of characters;
 /// @param Map - to associate characters with edges, its key_type shall be T.
-///              std::map is preferable for small alphabet.
+///              std::map is preferable for small alphabet,
+///              step::flat_map saves memory and allocations;
+/// @param Allocator - for the text and the nodes. It is passed to the Map
+///                    if the Map is constructible with it, so that
+///                    the whole tree can be placed in step::arena.
+/// With pop_front it becomes a sliding window over a stream of characters.
 /// @see https://en.wikipedia.org/wiki/Suffix_tree
 template <class T = char,
           class Size = size_t,
-          template <class...> class Map = std::unordered_map>
+          template <class...> class Map = std::unordered_map,
+          class Allocator = std::allocator<T>>
 class suffix_tree {
 public:
     using value_type = T;
     using size_type = Size;
+    using allocator_type = Allocator;
     using substring = std::pair<Size, Size>;  ///< half-open offset range
 
-    auto data() const { return str_.data(); }
-    Size size() const { return (Size)str_.size(); }
+    suffix_tree() = default;
+
+    explicit suffix_tree(const Allocator& alloc)
+        : str_(alloc)
+        , nodes_(alloc)
+        , free_(alloc)
+        , window_(alloc)
+        , chars_(alloc)
+    {
+    }
+
+    /// Construct from the suffix array of the text.
+
+    /// Inner nodes are the intervals of the longest common prefix array,
+    /// they are produced in one pass over the suffixes in lexicographical
+    /// order. Suffix links are found top-down by skip/count from the link
+    /// of the parent, so push_back can continue from here.
+    /// Time complexity O(N), where: N - text length.
+    template <class Compare>
+    explicit suffix_tree(const suffix_array_view<T, Size, Compare>& arr,
+                         const Allocator& alloc = Allocator())
+        : suffix_tree(alloc)
+    {
+        str_.assign(arr.data(), arr.data() + arr.size());
+        if (arr.size())
+            build(arr);
+    }
+
+    template <class Compare>
+    explicit suffix_tree(const suffix_array<T, Size, Compare>& arr,
+                         const Allocator& alloc = Allocator())
+        : suffix_tree(suffix_array_view<T, Size, Compare>{arr}, alloc)
+    {
+    }
+
+    allocator_type get_allocator() const { return str_.get_allocator(); }
+
+    auto data() const { return str_.data() + front_; }
+    Size size() const { return Size(str_.size() - front_); }
 
     void clear() noexcept
     {
         str_.clear();
         nodes_.clear();
-        char_ = node_ = 0;
+        char_ = node_ = front_ = 0;
+        free_.clear();
+        window_.clear();
+        chars_.clear();
     }
 
     void reserve(Size len)
@@ -47,27 +100,87 @@ public:
     /// Basic exception guarantee
     void push_back(T val)
     try {
-        str_.push_back(val);
         if (nodes_.empty())
-            nodes_.emplace_back();
-        auto tie = [&, src = nodes()](Size dest) mutable {
-            if (!leaf(src) && src != dest)
-                nodes_[src++].link = dest;
-        };
+            nodes_.push_back({make_map(), {}, {}});
+        extend(val);
+    }
+    catch (...) {
+        clear();
+        throw;
+    }
+
+    /// Push back the characters in one batch.
+
+    /// Storage grows once for forward iterators.
+    /// Basic exception guarantee
+    template <class InputIt>
+    void append(InputIt first, InputIt last)
+    try {
+        using category =
+            typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>)
+            grow(std::distance(first, last));
+        if (first != last && nodes_.empty())
+            nodes_.push_back({make_map(), {}, {}});
+        for (; first != last; ++first)
+            extend(*first);
+    }
+    catch (...) {
+        clear();
+        throw;
+    }
+
+    template <class InputRng>
+    void append(const InputRng& rng)
+    {
+        append(std::begin(rng), std::end(rng));
+    }
+
+    /// Remove the first character, the tree is left with the suffixes
+    /// of the rest of the text.
+
+    /// Sliding window of Larsson: the leaf of the longest suffix is deleted,
+    /// its parent is merged with the other child if it is the only one.
+    /// If the longest implicit suffix occurred only there, the leaf is
+    /// passed to it instead. Inner nodes labeled with the removed occurrence
+    /// are relabeled with the newest occurrence among their children.
+    /// The text is compacted when popped characters outnumber the rest,
+    /// so memory stays proportional to size().
+    /// Amortized time complexity O(K*L), where: K - alphabet size,
+    /// L - number of inner nodes labeled with the removed occurrence,
+    /// it is mostly zero or one. The first call takes O(N) for bookkeeping.
+    /// The tree shall not be empty, offsets are invalidated.
+    /// Basic exception guarantee.
+    void pop_front()
+    try {
+        if (!sliding())
+            track();
         while (reminder()) {
-            if (Size& child = nodes_[node_].children[str_[char_]]) {
-                if (descend(child))
-                    continue;
-                if (!split(child))
-                    return tie(node_);
-                tie(nodes() - 1);
-            }
-            else {
-                child = flip(char_);
-                tie(node_);
-            }
+            Size child = nodes_[node_].children.find(str_[char_])->second;
+            if (!descend(child))
+                break;
+        }
+        Size pos = front_;
+        Size parent = chars_[pos].leaf;
+        Size first = pos + window_[parent].depth;
+        auto& children = nodes_[parent].children;
+        if (reminder() && node_ == parent && eq_(str_[char_], str_[first])) {
+            Size suffix = char_ - window_[parent].depth;
+            children.find(str_[first])->second = flip(char_);
+            attach(parent, suffix);
             node_ ? node_ = nodes_[node_].link : ++char_;
         }
+        else {
+            children.erase(str_[first]);
+            if (parent && children.size() == 1)
+                merge(parent);
+        }
+        while (Size node = chars_[pos].label)
+            refresh(node);
+        ++front_;
+        nodes_.front().rng = {front_, front_};
+        if (front_ > size())
+            compact();
     }
     catch (...) {
         clear();
@@ -128,11 +241,61 @@ public:
             dfs({}, std::forward<Visitor>(viz));
     }
 
+    /// Depth-first traversal of the subtrees in parallel.
+
+    /// The tree is split breadth-first into many more subtrees than threads,
+    /// each thread takes the next one when done with the previous.
+    /// Every thread visits with its own copy of viz, that shall be
+    /// the identity of reduce. Edges above the subtrees are visited by
+    /// the calling thread. The order of visited edges is unspecified.
+    /// @code viz = tree.visit(viz, [](auto lhs, auto rhs) {...}, 4); @endcode
+    /// @return copies of viz merged by reduce(lhs, rhs).
+    template <class Visitor, class BinaryOp>
+    Visitor visit(Visitor viz, BinaryOp reduce, size_t threads) const
+    {
+        threads = std::max<size_t>(threads, 1);
+        auto vizs = std::vector<Visitor>(threads, viz);
+        if (nodes_.empty())
+            return viz;
+        auto inner = std::vector<visited_edge>{};
+        auto subtrees = std::vector<visited_edge>{visited_edge{}};
+        for (bool split = true; split && subtrees.size() < threads * 16;) {
+            split = false;
+            auto next = std::vector<visited_edge>{};
+            for (auto& edge : subtrees) {
+                if (leaf(edge.child)) {
+                    next.push_back(edge);
+                    continue;
+                }
+                split = true;
+                viz(std::as_const(edge));
+                inner.push_back(edge);
+                for (auto& pair : nodes_[edge.child].children)
+                    next.push_back(child_edge(edge, pair.second));
+            }
+            subtrees.swap(next);
+        }
+        std::atomic<size_t> todo{0};
+        parallel::for_each_chunk(
+            threads, threads, [&](size_t chunk, size_t, size_t) {
+                for (size_t i; (i = todo++) < subtrees.size();)
+                    dfs(subtrees[i], std::ref(vizs[chunk]));
+            });
+        for (auto it = inner.rbegin(); it != inner.rend(); ++it) {
+            it->visited = true;
+            viz(std::as_const(*it));
+        }
+        for (auto& other : vizs)
+            viz = reduce(std::move(viz), std::move(other));
+        return viz;
+    }
+
     bool leaf(Size node) const { return node >= nodes(); }
 
     substring substr(Size node) const
     {
-        return leaf(node) ? substring{flip(node), size()} : nodes_[node].rng;
+        auto [first, last] = range(node);
+        return {Size(first - front_), Size(last - front_)};
     }
 
     substring path(const visited_edge& edge) const
@@ -142,24 +305,180 @@ public:
     }
 
 private:
-    inline static const auto eq_ = key_equal_or_equivalence_t<Map<T, Size>>{};
+    friend detail::suffix_tree_access;
+
+    using map_type = Map<T, Size>;
+
+    inline static const auto eq_ = key_equal_or_equivalence_t<map_type>{};
 
     struct inner_node {
-        Map<T, Size> children;
+        map_type children;
         substring rng;
         Size link;
     };
 
-    std::vector<T> str_;
-    std::vector<inner_node> nodes_;
+    template <class U>
+    using rebind_alloc =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<U>;
+
+    struct window_node {
+        Size depth;
+        Size parent;
+        Size prev;  // inner nodes labeled at the same position
+        Size next;
+    };
+
+    struct window_char {
+        Size leaf;   // parent of the leaf of the suffix
+        Size label;  // first inner node labeled at the position
+    };
+
+    // offsets are from the beginning of str_, popped characters included
+    std::vector<T, Allocator> str_;
+    std::vector<inner_node, rebind_alloc<inner_node>> nodes_;
     Size char_{}, node_{};  // active
+    Size front_{};
+    std::vector<Size, rebind_alloc<Size>> free_;  // deleted inner nodes
 
-    Size reminder() const { return size() - char_; }
+    // sliding window, it is tracked from the first pop_front
+    std::vector<window_node, rebind_alloc<window_node>> window_;
+    std::vector<window_char, rebind_alloc<window_char>> chars_;
+
+    Size length() const { return (Size)str_.size(); }
+    Size reminder() const { return length() - char_; }
     Size nodes() const { return (Size)nodes_.size(); }
+    bool sliding() const { return !window_.empty(); }
+
+    substring range(Size node) const
+    {
+        return leaf(node) ? substring{flip(node), length()} : nodes_[node].rng;
+    }
+
+    map_type make_map() const
+    {
+        if constexpr (std::uses_allocator_v<map_type, Allocator>)
+            return map_type(get_allocator());
+        else
+            return map_type{};
+    }
+
+    template <class Compare>
+    void build(const suffix_array_view<T, Size, Compare>& arr)
+    {
+        auto lcp = std::vector<Size>(size());
+        arr.longest_common_prefix_array(lcp.begin());
+
+        // suffixes from char_ are implicit, they are prefixes of the others
+        char_ = size();
+        for (Size i = 0; i < size(); ++i)
+            if (lcp[i] == size() - arr.nth_element(i))
+                char_ = std::min(char_, arr.nth_element(i));
+
+        struct item {
+            Size node;
+            Size depth;
+            Size pos;  // of the first occurrence
+            bool leaf;
+        };
+        nodes_.reserve(char_);  // inner nodes have two or more children
+        auto depths = std::vector<Size>{0};
+        auto stack = std::vector<item>{{0, 0, size(), false}};
+        auto attach = [&](const item& child, item& parent) {
+            parent.pos = std::min(parent.pos, child.pos);
+            Size first = child.pos + parent.depth;
+            if (!child.leaf)
+                nodes_[child.node].rng = {first, child.pos + child.depth};
+            nodes_[parent.node].children[str_[first]] =
+                child.leaf ? flip(first) : child.node;
+        };
+        nodes_.push_back({make_map(), {}, {}});
+        for (Size i = 0, lcp_prev = 0; i <= size(); ++i) {
+            if (i < size() && arr.nth_element(i) >= char_) {
+                lcp_prev = std::min(lcp_prev, lcp[i]);
+                continue;
+            }
+            while (stack.back().depth > lcp_prev) {
+                auto child = stack.back();
+                stack.pop_back();
+                if (stack.back().depth < lcp_prev) {
+                    stack.push_back({nodes(), lcp_prev, size(), false});
+                    nodes_.push_back({make_map(), {}, {}});
+                    depths.push_back(lcp_prev);
+                }
+                attach(child, stack.back());
+            }
+            if (i < size()) {
+                Size pos = arr.nth_element(i);
+                stack.push_back({{}, Size(size() - pos), pos, true});
+                lcp_prev = lcp[i];
+            }
+        }
+
+        for (auto todo = std::vector<Size>{0}; !todo.empty();) {
+            Size parent = todo.back();
+            todo.pop_back();
+            for (auto& pair : nodes_[parent].children) {
+                Size node = pair.second;
+                if (leaf(node))
+                    continue;
+                Size depth = depths[node] - 1;
+                Size pos = nodes_[node].rng.second - depth;
+                Size link = parent ? nodes_[parent].link : 0;
+                while (depths[link] < depth)
+                    link = nodes_[link]
+                               .children.find(str_[pos + depths[link]])
+                               ->second;
+                nodes_[node].link = link;
+                todo.push_back(node);
+            }
+        }
+    }
+
+    void extend(T val)
+    {
+        str_.push_back(val);
+        if (sliding())
+            chars_.push_back({});
+        auto tie = [&, src = Size{}](Size dest, Size next) mutable {
+            if (src)
+                nodes_[src].link = dest;
+            src = next;  // waits for the suffix link
+        };
+        while (reminder()) {
+            if (Size& child = nodes_[node_].children[str_[char_]]) {
+                if (descend(child))
+                    continue;
+                Size node = split(child);
+                if (!node)
+                    return tie(node_, 0);
+                tie(node, node);
+            }
+            else {
+                child = flip(char_);
+                if (sliding())
+                    attach(node_, char_ - window_[node_].depth);
+                tie(node_, 0);
+            }
+            node_ ? node_ = nodes_[node_].link : ++char_;
+        }
+    }
+
+    /// Reserve geometrically for len more characters
+    void grow(size_t len)
+    {
+        size_t cap = str_.capacity();
+        if (str_.size() + len <= cap)
+            return;
+        cap = std::max(str_.size() + len, 2 * cap);
+        str_.reserve(cap);
+        nodes_.reserve(cap);
+        if (sliding())
+            chars_.reserve(cap);
+    }
 
     bool descend(Size node)
     {
-        Size len = step::size(substr(node));
+        Size len = step::size(range(node));
         if (reminder() <= len)
             return false;
         char_ += len;
@@ -167,20 +486,151 @@ private:
         return true;
     }
 
-    bool split(Size& child)
+    /// Return the new inner node or zero
+    Size split(Size& child)
     {
-        auto rng = substr(child);
+        auto rng = range(child);
         Size cut = rng.first + reminder() - 1;
-        Size back = size() - 1;
+        Size back = length() - 1;
         if (eq_(str_[cut], str_[back]))
-            return false;
-        Size old = std::exchange(child, nodes());
-        nodes_.push_back({{{str_[cut], leaf(old) ? flip(cut) : old},
-                           {str_[back], flip(back)}},
-                          {rng.first, cut}});
+            return 0;
+        Size node = free_.empty() ? nodes() : free_.back();
+        Size old = std::exchange(child, node);
+        auto children = make_map();
+        children[str_[cut]] = leaf(old) ? flip(cut) : old;
+        children[str_[back]] = flip(back);
+        if (node == nodes())
+            nodes_.push_back({std::move(children), {rng.first, cut}, {}});
+        else {
+            nodes_[node] = {std::move(children), {rng.first, cut}, {}};
+            free_.pop_back();
+        }
         if (!leaf(old))
             nodes_[old].rng = {cut, rng.second};
-        return true;
+        if (!sliding())
+            return node;
+        Size depth = window_[node_].depth + (cut - rng.first);
+        auto val = window_node{depth, node_, 0, 0};
+        if (node == window_.size())
+            window_.push_back(val);
+        else
+            window_[node] = val;
+        if (leaf(old))
+            chars_[cut - depth].leaf = node;
+        else
+            window_[old].parent = node;
+        chars_[back - depth].leaf = node;
+        enlist(node, back - depth);
+        return node;
+    }
+
+    /// Set up the bookkeeping of the sliding window
+    void track()
+    {
+        window_.assign(nodes(), window_node{});
+        chars_.assign(str_.size(), window_char{});
+        for (auto todo = std::vector<Size>{0}; !todo.empty();) {
+            Size node = todo.back();
+            todo.pop_back();
+            Size depth = window_[node].depth;
+            for (auto& pair : nodes_[node].children) {
+                Size child = pair.second;
+                if (leaf(child)) {
+                    chars_[flip(child) - depth].leaf = node;
+                    continue;
+                }
+                auto rng = nodes_[child].rng;
+                Size child_depth = depth + step::size(rng);
+                window_[child] = {child_depth, node, 0, 0};
+                enlist(child, rng.second - child_depth);
+                todo.push_back(child);
+            }
+        }
+    }
+
+    /// Label the inner node with the occurrence of its path at pos
+    void enlist(Size node, Size pos)
+    {
+        auto& win = window_[node];
+        nodes_[node].rng = {pos + window_[win.parent].depth, pos + win.depth};
+        win.prev = 0;
+        win.next = std::exchange(chars_[pos].label, node);
+        if (win.next)
+            window_[win.next].prev = node;
+    }
+
+    void delist(Size node)
+    {
+        auto& win = window_[node];
+        Size pos = nodes_[node].rng.second - win.depth;
+        (win.prev ? window_[win.prev].next : chars_[pos].label) = win.next;
+        if (win.next)
+            window_[win.next].prev = win.prev;
+    }
+
+    /// The leaf of the suffix is the child of the node
+    void attach(Size node, Size suffix)
+    {
+        chars_[suffix].leaf = node;
+        if (node) {
+            delist(node);
+            enlist(node, suffix);
+        }
+    }
+
+    void refresh(Size node)
+    {
+        Size pos = 0;
+        for (auto& pair : nodes_[node].children) {
+            Size child = pair.second;
+            pos = std::max<Size>(
+                pos,
+                leaf(child) ? flip(child) - window_[node].depth
+                            : nodes_[child].rng.second - window_[child].depth);
+        }
+        delist(node);
+        enlist(node, pos);
+    }
+
+    /// Replace the inner node with its only child
+    void merge(Size node)
+    {
+        auto& win = window_[node];
+        auto rng = nodes_[node].rng;
+        Size len = step::size(rng);
+        Size child = nodes_[node].children.begin()->second;
+        if (leaf(child)) {
+            chars_[flip(child) - win.depth].leaf = win.parent;
+            child += len;  // flip of the preceding offset
+        }
+        else {
+            window_[child].parent = win.parent;
+            nodes_[child].rng.first -= len;
+        }
+        nodes_[win.parent].children.find(str_[rng.first])->second = child;
+        if (node_ == node) {
+            node_ = win.parent;
+            char_ -= len;
+        }
+        delist(node);
+        nodes_[node].children = make_map();
+        free_.push_back(node);
+    }
+
+    /// Drop popped characters
+    void compact()
+    {
+        Size shift = std::exchange(front_, 0);
+        str_.erase(str_.begin(), str_.begin() + shift);
+        chars_.erase(chars_.begin(), chars_.begin() + shift);
+        for (auto& node : nodes_) {
+            node.rng.first -= shift;
+            node.rng.second -= shift;
+            for (auto& pair : node.children)
+                if (leaf(pair.second))
+                    pair.second += shift;
+        }
+        char_ -= shift;
     }
 
     template <class InputIt>
@@ -204,12 +654,15 @@ private:
         return std::nullopt;
     }
 
+    visited_edge child_edge(const visited_edge& src, Size child) const
+    {
+        return {src.child, child, Size(src.path + step::size(substr(child)))};
+    }
+
     void spawn(visited_edge src, std::stack<visited_edge>& dest) const
     {
         for (auto& pair : nodes_[src.child].children)
-            dest.push({src.child,
-                       pair.second,
-                       Size(src.path + step::size(substr(pair.second)))});
+            dest.push(child_edge(src, pair.second));
     }
 
     template <class Visitor>
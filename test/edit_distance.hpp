@@ -5,6 +5,7 @@
 
 #include <step/edit_distance.hpp>
 #include <step/test/case_insensitive.hpp>
+#include <random>
 #include <string_view>
 
 using option_t = std::optional<char>;
@@ -74,4 +75,160 @@ TEST_CASE("edit_distance_join")
     }
 }
 
+template <class T>
+auto random_string(std::mt19937& gen, size_t len, size_t alphabet)
+{
+    std::uniform_int_distribution<size_t> dist{0, alphabet - 1};
+    std::vector<T> result;
+    std::generate_n(
+        std::back_inserter(result), len, [&] { return T('a' + dist(gen)); });
+    return result;
+}
+
+template <class T>
+size_t edit_distance_cost(const std::vector<T>& lhs, const std::vector<T>& rhs)
+{
+    using opt_t = std::optional<T>;
+    std::vector<std::pair<opt_t, opt_t>> pairs;
+    step::edit_distance::join(lhs, rhs, std::back_inserter(pairs));
+    std::vector<std::pair<opt_t, opt_t>> expect;
+    step::edit_distance::join(
+        lhs, rhs, std::back_inserter(expect), [](T a, T b) { return a == b; });
+    CHECK(pairs == expect);
+    std::vector<std::pair<opt_t, opt_t>> parallel;
+    step::edit_distance::join(
+        lhs, rhs, std::back_inserter(parallel), std::equal_to{}, 4);
+    CHECK(pairs == parallel);
+    static step::workspace ws;  // reused between the calls
+    std::vector<std::pair<opt_t, opt_t>> reused;
+    step::edit_distance::join(
+        lhs, rhs, std::back_inserter(reused), std::equal_to{}, ws);
+    CHECK(pairs == reused);
+    return std::count_if(pairs.begin(), pairs.end(), [](auto& pair) {
+        return pair.first != pair.second;
+    });
+}
+
+TEST_CASE("edit_distance_bit_parallel")
+{
+    std::mt19937 gen{std::random_device{}()};
+    for (size_t len : {0, 1, 2, 5, 63, 64, 65, 127, 128, 129, 200, 300})
+        for (size_t alphabet : {1, 2, 4, 26}) {
+            auto lhs = random_string<char>(gen, len, alphabet);
+            auto rhs = random_string<char>(gen, len * 3 / 4 + 1, alphabet);
+            edit_distance_cost(lhs, rhs);
+            edit_distance_cost(rhs, lhs);
+        }
+    for (size_t len : {64, 65, 300, 700}) {  // sparse match table
+        auto lhs = random_string<int>(gen, len, 500);
+        auto rhs = random_string<int>(gen, len, 500);
+        edit_distance_cost(lhs, rhs);
+    }
+    auto wide = std::vector<char>(70000, 'a');  // 32-bit cells
+    wide[500] = 'b';
+    CHECK(step::edit_distance::distance(
+              wide,
+              std::vector<char>(100, 'a'),
+              [](char a, char b) { return a == b; }) == 69900);
+    auto kitten = std::vector<char>{'k', 'i', 't', 't', 'e', 'n'};
+    auto sitting = std::vector<char>{'s', 'i', 't', 't', 'i', 'n', 'g'};
+    CHECK(edit_distance_cost(kitten, sitting) == 3);
+}
+
+TEST_CASE("edit_distance_anchored_join")
+{
+    std::mt19937 gen{std::random_device{}()};
+    for (size_t len : {0, 1, 10, 100, 300})
+        for (size_t alphabet : {2, 26, 100}) {
+            auto lhs = random_string<char>(gen, len, alphabet);
+            auto rhs = random_string<char>(gen, len / 2 + 1, alphabet);
+            std::vector<std::pair<option_t, option_t>> pairs;
+            step::edit_distance::anchored_join(
+                lhs, rhs, std::back_inserter(pairs));
+            std::vector<char> first, second;
+            size_t cost = 0;
+            for (auto& [l, r] : pairs) {
+                if (l)
+                    first.push_back(*l);
+                if (r)
+                    second.push_back(*r);
+                cost += l != r;
+            }
+            CHECK(first == lhs);
+            CHECK(second == rhs);
+            CHECK(cost >= step::edit_distance::distance(lhs, rhs));
+        }
+}
+
+TEST_CASE("edit_distance_distance")
+{
+    using namespace std::literals;
+    CHECK(step::edit_distance::distance("kitten"sv, "sitting"sv) == 3);
+    CHECK(step::edit_distance::distance(
+              "SUNDAY"sv, "saturday"sv, step::case_insensitive::equal_to{}) ==
+          3);
+    CHECK(!step::edit_distance::distance_bounded("kitten"sv, "sitting"sv, 2));
+    CHECK(step::edit_distance::distance_bounded("kitten"sv, "sitting"sv, 3) ==
+          3);
+    CHECK(step::edit_distance::distance_bounded(""sv, "abc"sv, 3) == 3);
+    CHECK(!step::edit_distance::distance_bounded(""sv, "abc"sv, 2));
+    CHECK(step::edit_distance::distance_bounded(""sv, ""sv, 0) == 0);
+    std::mt19937 gen{std::random_device{}()};
+    for (size_t len : {0, 1, 2, 5, 20, 70, 150})
+        for (size_t alphabet : {1, 2, 4, 26}) {
+            auto lhs = random_string<char>(gen, len, alphabet);
+            auto rhs = random_string<char>(gen, len * 2 / 3 + 1, alphabet);
+            auto expect = step::edit_distance::distance(
+                lhs, rhs, [](char a, char b) { return a == b; });
+            CHECK(step::edit_distance::distance(lhs, rhs) == expect);
+            for (size_t k : {size_t{0}, size_t{1}, expect / 2, expect,
+                             expect + 1, expect + 10, size_t(-1)}) {
+                auto bounded =
+                    step::edit_distance::distance_bounded(lhs, rhs, k);
+                CHECK(bounded == (expect <= k ? std::optional{expect}
+                                              : std::nullopt));
+                CHECK(step::edit_distance::distance_bounded(rhs, lhs, k) ==
+                      bounded);
+            }
+        }
+}
+
+TEST_CASE("edit_distance_benchmark")
+{
+    std::mt19937 gen{std::random_device{}()};
+    auto lhs = random_string<char>(gen, 2000, 4);
+    auto rhs = random_string<char>(gen, 2000, 4);
+    using pair_t = std::pair<std::optional<char>, std::optional<char>>;
+    BENCHMARK("2000 chars edit distance")
+    {
+        std::vector<pair_t> pairs;
+        step::edit_distance::join(lhs, rhs, std::back_inserter(pairs));
+        return pairs.size();
+    };
+    BENCHMARK("2000 chars edit distance (custom predicate)")
+    {
+        std::vector<pair_t> pairs;
+        step::edit_distance::join(lhs,
+                                  rhs,
+                                  std::back_inserter(pairs),
+                                  [](char a, char b) { return a == b; });
+        return pairs.size();
+    };
+    BENCHMARK("2000 chars edit distance (distance only)")
+    {
+        return step::edit_distance::distance(lhs, rhs);
+    };
+    auto similar = lhs;
+    for (size_t i = 0; i < similar.size(); i += 100)
+        similar[i] = 'z';
+    BENCHMARK("2000 chars edit distance (bounded by 30)")
+    {
+        return step::edit_distance::distance_bounded(lhs, similar, 30);
+    };
+    BENCHMARK("2000 chars edit distance (bounded by 30, early exit)")
+    {
+        return step::edit_distance::distance_bounded(lhs, rhs, 30);
+    };
+}
+
 #endif  // STEP_TEST_EDIT_DISTANCE_HPP
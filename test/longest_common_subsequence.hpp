@@ -3,6 +3,7 @@
 #ifndef STEP_TEST_LONGEST_COMMON_SUBSEQUENCE_HPP
 #define STEP_TEST_LONGEST_COMMON_SUBSEQUENCE_HPP
 
+#include <random>
 #include <sstream>
 #include <step/example/diff/utility.hpp>
 #include <step/longest_common_subsequence.hpp>
@@ -41,6 +42,199 @@ TEST_CASE("longest_common_subsequence_intersection")
     }
 }
 
+template <class T>
+bool is_subsequence(const std::vector<T>& sub, const std::vector<T>& str)
+{
+    auto it = str.begin();
+    for (auto& val : sub)
+        if ((it = std::find(it, str.end(), val)) == str.end())
+            return false;
+        else
+            ++it;
+    return true;
+}
+
+template <class T>
+size_t lcs_length(const std::vector<T>& lhs, const std::vector<T>& rhs)
+{
+    std::vector<std::vector<size_t>> tbl(lhs.size() + 1,
+                                         std::vector<size_t>(rhs.size() + 1));
+    for (size_t l = 1; l <= lhs.size(); ++l)
+        for (size_t r = 1; r <= rhs.size(); ++r)
+            tbl[l][r] = lhs[l - 1] == rhs[r - 1]
+                            ? tbl[l - 1][r - 1] + 1
+                            : std::max(tbl[l - 1][r], tbl[l][r - 1]);
+    return tbl[lhs.size()][rhs.size()];
+}
+
+template <class T>
+void check_lcs(const std::vector<T>& lhs, const std::vector<T>& rhs)
+{
+    std::vector<T> sub;
+    step::longest_common_subsequence::intersection(
+        lhs, rhs, std::back_inserter(sub));
+    CHECK(sub.size() == lcs_length(lhs, rhs));
+    CHECK(is_subsequence(sub, lhs));
+    CHECK(is_subsequence(sub, rhs));
+    std::vector<T> expect;
+    step::longest_common_subsequence::intersection(
+        lhs, rhs, std::back_inserter(expect), [](T a, T b) { return a == b; });
+    CHECK(sub == expect);
+    std::vector<T> parallel;
+    step::longest_common_subsequence::intersection(
+        lhs, rhs, std::back_inserter(parallel), std::equal_to{}, 4);
+    CHECK(sub == parallel);
+    static step::workspace ws;  // reused between the calls
+    std::vector<T> reused;
+    step::longest_common_subsequence::intersection(
+        lhs, rhs, std::back_inserter(reused), std::equal_to{}, ws);
+    CHECK(sub == reused);
+    std::vector<T> myers;
+    step::longest_common_subsequence::myers_intersection(
+        lhs, rhs, std::back_inserter(myers));
+    CHECK(myers.size() == sub.size());
+    CHECK(is_subsequence(myers, lhs));
+    CHECK(is_subsequence(myers, rhs));
+    std::vector<T> anchored;
+    step::longest_common_subsequence::anchored_intersection(
+        lhs, rhs, std::back_inserter(anchored));
+    CHECK(anchored.size() <= sub.size());
+    CHECK(is_subsequence(anchored, lhs));
+    CHECK(is_subsequence(anchored, rhs));
+}
+
+template <class T>
+std::vector<T> random_vector(std::mt19937& gen, size_t len, int alphabet)
+{
+    std::uniform_int_distribution<int> dist{0, alphabet - 1};
+    std::vector<T> result;
+    std::generate_n(
+        std::back_inserter(result), len, [&] { return T('a' + dist(gen)); });
+    return result;
+}
+
+TEST_CASE("longest_common_subsequence_random")
+{
+    std::mt19937 gen{std::random_device{}()};
+    for (size_t len : {0, 1, 2, 5, 63, 64, 65, 130, 300})
+        for (int alphabet : {1, 2, 4, 26})
+            check_lcs(random_vector<char>(gen, len, alphabet),
+                      random_vector<char>(gen, len / 2 + 3, alphabet));
+    for (size_t len : {64, 65, 300, 700})  // sparse match table
+        check_lcs(random_vector<int>(gen, len, 500),
+                  random_vector<int>(gen, len, 500));
+    for (size_t len : {10, 100, 1000})
+        for (int alphabet : {2, 26}) {  // similar sequences
+            auto lhs = random_vector<char>(gen, len, alphabet);
+            auto rhs = lhs;
+            std::uniform_int_distribution<size_t> pos{0, len - 1};
+            for (size_t i = 0; i < len / 20 + 1; ++i) {
+                rhs.erase(rhs.begin() + pos(gen) % rhs.size());
+                rhs.insert(rhs.begin() + pos(gen) % rhs.size(), 'z');
+            }
+            check_lcs(lhs, rhs);
+        }
+}
+
+TEST_CASE("longest_common_subsequence_myers")
+{
+    using namespace std::literals;
+    std::string str;
+    step::longest_common_subsequence::myers_intersection(
+        "ABCABBA"sv, "CBABAC"sv, std::back_inserter(str));
+    CHECK(str.size() == 4);
+    str.clear();
+    step::longest_common_subsequence::myers_intersection(
+        "XMJYAUZ"sv,
+        "mzjawxu"sv,
+        std::back_inserter(str),
+        step::case_insensitive::equal_to{});
+    CHECK(str == "MJAU");
+}
+
+TEST_CASE("longest_common_subsequence_anchored")
+{
+    using namespace std::literals;
+    auto lhs = std::vector{"a"sv, "b"sv, "x"sv, "c"sv, "d"sv, "x"sv};
+    auto rhs = std::vector{"c"sv, "a"sv, "b"sv, "x"sv, "x"sv, "d"sv};
+    std::vector<std::string_view> sub;
+    step::longest_common_subsequence::anchored_intersection(
+        lhs, rhs, std::back_inserter(sub));
+    CHECK(sub == std::vector{"a"sv, "b"sv, "x"sv, "d"sv});
+    std::string str;
+    step::longest_common_subsequence::anchored_intersection(
+        "ABCDEF"sv, "ABXDEF"sv, std::back_inserter(str));
+    CHECK(str == "ABDEF");
+}
+
+TEST_CASE("longest_common_subsequence_benchmark")
+{
+    std::mt19937 gen{std::random_device{}()};
+    auto lhs = random_vector<char>(gen, 2000, 4);
+    auto rhs = random_vector<char>(gen, 2000, 4);
+    BENCHMARK("2000 chars longest common subsequence")
+    {
+        std::vector<char> sub;
+        step::longest_common_subsequence::intersection(
+            lhs, rhs, std::back_inserter(sub));
+        return sub.size();
+    };
+    BENCHMARK("2000 chars longest common subsequence (Myers)")
+    {
+        std::vector<char> sub;
+        step::longest_common_subsequence::myers_intersection(
+            lhs, rhs, std::back_inserter(sub));
+        return sub.size();
+    };
+    auto similar = lhs;
+    for (size_t i = 0; i < similar.size(); i += 100)
+        similar[i] = 'z';
+    BENCHMARK("2000 similar chars longest common subsequence")
+    {
+        std::vector<char> sub;
+        step::longest_common_subsequence::intersection(
+            lhs, similar, std::back_inserter(sub));
+        return sub.size();
+    };
+    BENCHMARK("2000 similar chars longest common subsequence (Myers)")
+    {
+        std::vector<char> sub;
+        step::longest_common_subsequence::myers_intersection(
+            lhs, similar, std::back_inserter(sub));
+        return sub.size();
+    };
+    auto edited = lhs;
+    edited[edited.size() / 2] = 'z';
+    BENCHMARK("2000 chars longest common subsequence (single change)")
+    {
+        std::vector<char> sub;
+        step::longest_common_subsequence::intersection(
+            lhs, edited, std::back_inserter(sub));
+        return sub.size();
+    };
+    BENCHMARK("2000 chars longest common subsequence (anti-diagonal)")
+    {
+        std::vector<char> sub;
+        step::longest_common_subsequence::intersection(
+            lhs,
+            rhs,
+            std::back_inserter(sub),
+            [](char a, char b) { return a == b; });
+        return sub.size();
+    };
+    BENCHMARK("2000 chars longest common subsequence (4 threads)")
+    {
+        std::vector<char> sub;
+        step::longest_common_subsequence::intersection(
+            lhs,
+            rhs,
+            std::back_inserter(sub),
+            [](char a, char b) { return a == b; },
+            4);
+        return sub.size();
+    };
+}
+
 TEST_CASE("diff")
 {
     const std::string str1 = R"(This part of the
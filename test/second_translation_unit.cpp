@@ -1,13 +1,20 @@
 // Andrew Naplavkov
 
+#include <step/arena.hpp>
 #include <step/edit_distance.hpp>
 #include <step/example/diff/utility.hpp>
 #include <step/example/suffix_tree_viz/utility.hpp>
+#include <step/flat_map.hpp>
+#include <step/fm_index.hpp>
+#include <step/generalized_suffix_tree.hpp>
 #include <step/kahan.hpp>
 #include <step/longest_common_subsequence.hpp>
 #include <step/longest_common_substring.hpp>
 #include <step/longest_increasing_subsequence.hpp>
 #include <step/longest_repeated_substring.hpp>
+#include <step/mapped_suffix_array.hpp>
+#include <step/mapped_suffix_tree.hpp>
+#include <step/packed_uint.hpp>
 #include <step/maximum_subarray.hpp>
 #include <step/suffix_array.hpp>
 #include <step/suffix_tree.hpp>
@@ -5,10 +5,20 @@
 
 //#include <boost/container/flat_map.hpp>
 #include <array>
+#include <cstdio>
 #include <fstream>
 #include <map>
 #include <random>
+#include <set>
+#include <sstream>
+#include <step/arena.hpp>
 #include <step/example/suffix_tree_viz/utility.hpp>
+#include <step/flat_map.hpp>
+#include <step/fm_index.hpp>
+#include <step/generalized_suffix_tree.hpp>
+#include <step/mapped_suffix_array.hpp>
+#include <step/mapped_suffix_tree.hpp>
+#include <step/packed_uint.hpp>
 #include <step/suffix_array.hpp>
 #include <step/suffix_tree.hpp>
 #include <string>
@@ -194,7 +204,17 @@ static const auto texts = [] {
     return res;
 }();
 
-inline auto tree_order(const ordered_suffix_tree& tree)
+template <class Key, class T>
+using reverse_flat_map = step::flat_map<Key, T, std::greater<>>;
+
+template <class Key, class T>
+using arena_map = step::flat_map<Key,
+                                 T,
+                                 std::greater<>,
+                                 step::arena_allocator<std::pair<Key, T>>>;
+
+template <class Tree>
+auto tree_order(const Tree& tree)
 {
     std::vector<size_t> res;
     tree.visit([&](auto& edge) {
@@ -219,7 +239,509 @@ TEST_CASE("suffix_array_n_tree_cross_check")
         ordered_suffix_tree tree{};
         std::copy(str.begin(), str.end(), std::back_inserter(tree));
         CHECK(array_order(arr) == tree_order(tree));
+
+        step::suffix_tree<char, uint32_t, reverse_flat_map> flat{};
+        std::copy(str.begin(), str.end(), std::back_inserter(flat));
+        CHECK(array_order(arr) == tree_order(flat));
+
+        step::suffix_tree<char, step::uint40_t, reverse_flat_map> packed{};
+        packed.append(str);
+        CHECK(array_order(arr) == tree_order(packed));
+
+        step::suffix_tree<char, uint32_t, reverse_flat_map> batch{};
+        batch.append(str.substr(0, str.size() / 3));
+        std::istringstream is{str.substr(str.size() / 3)};
+        batch.append(std::istreambuf_iterator<char>{is},
+                     std::istreambuf_iterator<char>{});
+        CHECK(array_order(arr) == tree_order(batch));
+
+        step::arena mem;
+        {
+            using alloc_t = step::arena_allocator<char>;
+            step::suffix_tree<char, uint32_t, arena_map, alloc_t> tree{mem};
+            std::copy(str.begin(), str.end(), std::back_inserter(tree));
+            auto copy = tree;
+            CHECK(array_order(arr) == tree_order(copy));
+        }
+        mem.release();
+
+        step::suffix_array parallel{str, step::prefix_doubling{4}};
+        CHECK(array_order(parallel) == array_order(arr));
+
+        step::suffix_array radix{str, step::radix_doubling{}};
+        CHECK(array_order(radix) == array_order(arr));
+
+        step::suffix_array sais{str, step::induced_sorting{}};
+        CHECK(array_order(sais) == array_order(arr));
+    }
+}
+
+TEST_CASE("packed_uint")
+{
+    static_assert(sizeof(step::uint40_t) == 5);
+    static_assert(alignof(step::uint40_t) == 1);
+    constexpr uint64_t max = (uint64_t{1} << 40) - 1;
+    CHECK(std::numeric_limits<step::uint40_t>::max() == max);
+    CHECK(step::flip(step::uint40_t{}) == max);
+    step::uint40_t val = max - 1;
+    CHECK(++val == max);
+    CHECK(val++ == max);
+    CHECK(val == 0);
+    val -= 1;
+    CHECK(val == max);
+    val = uint64_t{0x0123456789};
+    CHECK(val + 1 == uint64_t{0x012345678a});
+}
+
+TEST_CASE("suffix_tree_from_suffix_array")
+{
+    using tree_t = step::suffix_tree<char, uint32_t, reverse_flat_map>;
+    std::mt19937 gen{std::random_device{}()};
+    auto paths = [](const tree_t& tree) {
+        std::vector<std::string_view> res;
+        tree.visit([&](auto& edge) {
+            auto [first, last] = tree.path(edge);
+            res.emplace_back(tree.data() + first, last - first);
+        });
+        return res;
+    };
+    for (size_t len = 0; len < 100; ++len)
+        for (auto alphabet : {"a"sv, "ab"sv, "ACGT"sv}) {
+            std::uniform_int_distribution<size_t> dist{0, alphabet.size() - 1};
+            std::string str;
+            std::generate_n(std::back_inserter(str), len, [&] {
+                return alphabet[dist(gen)];
+            });
+            auto half = str.substr(0, len / 2);
+            tree_t online{};
+            std::copy(str.begin(), str.end(), std::back_inserter(online));
+            tree_t offline{step::suffix_array<char, uint32_t>{half}};
+            std::copy(str.begin() + half.size(),
+                      str.end(),
+                      std::back_inserter(offline));
+            CHECK(paths(online) == paths(offline));
+            CHECK(tree_order(online) == tree_order(offline));
+            for (size_t pos = 0; pos < len; pos += 7) {
+                auto pattern = str.substr(pos, 5);
+                auto found = offline.find(pattern);
+                CHECK(str.compare(found, pattern.size(), pattern) == 0);
+            }
+        }
+    for (auto& str : texts) {
+        step::suffix_array<char, uint32_t> arr{str, step::induced_sorting{}};
+        tree_t tree{arr};
+        tree_t online{};
+        std::copy(str.begin(), str.end(), std::back_inserter(online));
+        CHECK(paths(tree) == paths(online));
+    }
+}
+
+template <class Tree>
+struct edge_counter {
+    const Tree* tree;
+    size_t edges = 0;
+    size_t leaves = 0;
+    size_t deepest = 0;
+
+    void operator()(const typename Tree::visited_edge& edge)
+    {
+        ++edges;
+        if (tree->leaf(edge.child))
+            ++leaves;
+        else if (edge.visited)
+            deepest = std::max<size_t>(deepest, edge.path);
+    }
+
+    friend edge_counter operator+(edge_counter lhs, const edge_counter& rhs)
+    {
+        lhs.edges += rhs.edges;
+        lhs.leaves += rhs.leaves;
+        lhs.deepest = std::max(lhs.deepest, rhs.deepest);
+        return lhs;
+    }
+};
+
+TEST_CASE("suffix_tree_parallel_visit")
+{
+    using tree_t = step::suffix_tree<char, uint32_t, step::flat_map>;
+    for (auto& str : texts) {
+        tree_t tree{};
+        std::copy(str.begin(), str.end(), std::back_inserter(tree));
+        edge_counter<tree_t> expect{&tree};
+        tree.visit(std::ref(expect));
+        CHECK(expect.leaves == str.size());
+        for (size_t threads : {1, 2, 5}) {
+            auto res = tree.visit(
+                edge_counter<tree_t>{&tree}, std::plus<>{}, threads);
+            CHECK(res.edges == expect.edges);
+            CHECK(res.leaves == expect.leaves);
+            CHECK(res.deepest == expect.deepest);
+        }
+    }
+}
+
+TEST_CASE("suffix_tree_sliding_window")
+{
+    using tree_t = step::suffix_tree<char, uint32_t, reverse_flat_map>;
+    std::mt19937 gen{std::random_device{}()};
+    auto paths = [](const tree_t& tree) {
+        std::vector<std::string_view> res;
+        tree.visit([&](auto& edge) {
+            auto [first, last] = tree.path(edge);
+            res.emplace_back(tree.data() + first, last - first);
+        });
+        return res;
+    };
+    for (auto alphabet : {"a"sv, "ab"sv, "ACGT"sv})
+        for (size_t window : {1, 2, 3, 5, 8, 13, 40}) {
+            std::uniform_int_distribution<size_t> dist{0, alphabet.size() - 1};
+            std::string str;
+            std::generate_n(std::back_inserter(str), 300, [&] {
+                return alphabet[dist(gen)];
+            });
+            auto half = str.substr(0, window / 2);
+            tree_t tree{step::suffix_array<char, uint32_t>{half}};
+            for (size_t i = half.size(); i < str.size(); ++i) {
+                tree.push_back(str[i]);
+                if (tree.size() > window)
+                    tree.pop_front();
+                auto text = std::string_view{tree.data(), tree.size()};
+                CHECK(text == str.substr(i + 1 - text.size(), text.size()));
+                tree_t expect{};
+                std::copy(text.begin(), text.end(), std::back_inserter(expect));
+                CHECK(paths(tree) == paths(expect));
+                CHECK(tree_order(tree) == tree_order(expect));
+                auto pattern = text.substr(text.size() / 2, 3);
+                auto found = tree.find(pattern);
+                CHECK(text.compare(found, pattern.size(), pattern) == 0);
+            }
+            while (tree.size()) {
+                tree.pop_front();
+                CHECK(tree_order(tree).size() <= tree.size());
+            }
+            CHECK(tree_order(tree).empty());
+        }
+    auto& str = texts.front();
+    step::suffix_tree<char, uint32_t> tree{};
+    for (size_t i = 0; i < str.size(); ++i) {
+        tree.push_back(str[i]);
+        if (tree.size() > 1000)
+            tree.pop_front();
+        if (i % 4099)
+            continue;
+        auto text = std::string_view{tree.data(), tree.size()};
+        CHECK(text == str.substr(i + 1 - text.size(), text.size()));
+        step::suffix_tree<char, uint32_t> expect{};
+        std::copy(text.begin(), text.end(), std::back_inserter(expect));
+        auto order = tree_order(tree), expect_order = tree_order(expect);
+        std::sort(order.begin(), order.end());
+        std::sort(expect_order.begin(), expect_order.end());
+        CHECK(order == expect_order);
+    }
+}
+
+TEST_CASE("generalized_suffix_tree_hello_world")
+{
+    step::generalized_suffix_tree tree{};
+    for (auto doc : {"banana"sv, "bandana"sv, "cabana"sv})
+        tree.push_back(doc);
+    std::vector<std::pair<size_t, size_t>> occurrences;
+    tree.find_all("ana"sv, std::back_inserter(occurrences));
+    std::sort(occurrences.begin(), occurrences.end());
+    CHECK(occurrences == decltype(occurrences){{0, 1}, {0, 3}, {1, 4}, {2, 3}});
+    CHECK(tree.document_frequency("band"sv) == 1);
+}
+
+TEST_CASE("generalized_suffix_tree_find_all")
+{
+    using tree_t = step::generalized_suffix_tree<char, uint32_t, std::map>;
+    using occurrences_t = std::vector<std::pair<uint32_t, uint32_t>>;
+    std::mt19937 gen{std::random_device{}()};
+    auto brute_force = [](const std::vector<std::string>& docs,
+                          const std::string& pattern) {
+        occurrences_t res;
+        for (uint32_t doc = 0; doc < docs.size(); ++doc)
+            for (size_t pos = 0; pos < docs[doc].size(); ++pos)
+                if (docs[doc].compare(pos, pattern.size(), pattern) == 0)
+                    res.emplace_back(doc, (uint32_t)pos);
+        return res;
+    };
+    for (auto alphabet : {"a"sv, "ab"sv, "ACGT"sv})
+        for (size_t max_len : {0, 1, 3, 10}) {
+            std::uniform_int_distribution<size_t> dist{0, alphabet.size() - 1};
+            std::uniform_int_distribution<size_t> len{0, max_len};
+            std::vector<std::string> docs(40);
+            for (auto& doc : docs)
+                std::generate_n(std::back_inserter(doc), len(gen), [&] {
+                    return alphabet[dist(gen)];
+                });
+            tree_t tree{};
+            for (uint32_t i = 0; i < docs.size(); ++i)
+                CHECK(tree.push_back(docs[i]) == i);
+            for (uint32_t i = 0; i < tree.size(); ++i)
+                CHECK(std::string_view(tree.data(i), tree.size(i)) == docs[i]);
+            for (int i = 0; i < 2; ++i, tree.build_document_frequency())
+                for (auto& doc : docs)
+                    for (size_t pos = 0; pos <= doc.size(); ++pos)
+                        for (auto pattern : {doc.substr(pos, 1),
+                                             doc.substr(pos, 3),
+                                             doc + "A"}) {
+                            auto expect = brute_force(docs, pattern);
+                            occurrences_t res;
+                            tree.find_all(pattern, std::back_inserter(res));
+                            std::sort(res.begin(), res.end());
+                            CHECK(res == expect);
+                            std::set<uint32_t> expect_docs;
+                            for (auto& item : expect)
+                                expect_docs.insert(item.first);
+                            CHECK(tree.document_frequency(pattern) ==
+                                  expect_docs.size());
+                        }
+        }
+}
+
+TEST_CASE("suffix_array_lcp_lr")
+{
+    std::mt19937 gen{std::random_device{}()};
+    for (auto& str : texts) {
+        step::suffix_array<char, uint32_t> arr{str, step::induced_sorting{}};
+        auto fast = arr;
+        fast.build_lcp_lr();
+        std::uniform_int_distribution<size_t> pos{0, str.size() - 1};
+        std::uniform_int_distribution<size_t> len{0, 16};
+        bool same = true;
+        for (int i = 0; i < 1000; ++i) {
+            auto pattern = str.substr(pos(gen), len(gen));
+            if (i % 2 && !pattern.empty())
+                pattern.back() = "ab#"[i % 3];
+            auto expect = arr.find_all(pattern);
+            auto found = fast.find_all(pattern);
+            same &= std::equal(
+                expect.first, expect.second, found.first, found.second);
+        }
+        CHECK(same);
+        CHECK(fast.find("not found"sv) == fast.size());
+        CHECK(fast.find(""sv) == arr.find(""sv));
+        std::istringstream is{str.substr(0, 100)};
+        auto found = fast.find(std::istreambuf_iterator<char>{is},
+                               std::istreambuf_iterator<char>{});
+        CHECK(found == arr.find(str.substr(0, 100)));
+    }
+}
+
+TEST_CASE("suffix_array_find_all_batch")
+{
+    for (auto& str : texts) {
+        step::suffix_array<char, uint32_t> arr{str, step::induced_sorting{}};
+        std::vector<std::string> patterns{"", "not found", "#include <"};
+        for (size_t pos = 0; pos < str.size(); pos += str.size() / 500)
+            patterns.push_back(str.substr(pos, pos % 24));
+        for (size_t threads : {1, 3}) {
+            std::vector<std::pair<size_t, decltype(arr.find_all(""sv))>> res;
+            arr.find_all_batch(patterns.begin(),
+                               patterns.end(),
+                               std::back_inserter(res),
+                               threads);
+            REQUIRE(res.size() == patterns.size());
+            std::vector<bool> seen(patterns.size());
+            bool same = true;
+            for (auto& [i, rng] : res) {
+                seen[i] = true;
+                same &= rng == arr.find_all(patterns[i]);
+            }
+            CHECK(same);
+            CHECK(std::find(seen.begin(), seen.end(), false) == seen.end());
+        }
+    }
+}
+
+TEST_CASE("mapped_suffix_array")
+{
+    auto file = "mapped_suffix_array.tmp";
+    for (bool lcp : {false, true})
+        for (auto& str : texts) {
+            step::suffix_array<char, uint32_t> arr{str};
+            {
+                std::ofstream os{file, std::ios::binary};
+                step::save(arr, os, lcp);
+            }
+            step::mapped_suffix_array<char, uint32_t> mapped{file};
+            REQUIRE(mapped.size() == arr.size());
+            CHECK(std::equal(str.begin(), str.end(), mapped.data()));
+            bool same_order = true;
+            for (uint32_t i = 0; i < arr.size(); ++i)
+                same_order &= arr.nth_element(i) == mapped.nth_element(i);
+            CHECK(same_order);
+            std::vector<uint32_t> expect(arr.size()), lcps(arr.size());
+            arr.longest_common_prefix_array(expect.begin());
+            mapped.longest_common_prefix_array(lcps.begin());
+            CHECK(lcps == expect);
+            auto pattern = str.substr(str.size() / 2, 8);
+            arr.build_lcp_lr();
+            auto arr_all = arr.find_all(pattern);
+            auto mapped_all = mapped.find_all(pattern);
+            CHECK(std::equal(arr_all.first,
+                             arr_all.second,
+                             mapped_all.first,
+                             mapped_all.second));
+            CHECK(mapped.find(pattern) == arr.find(pattern));
+        }
+    std::remove(file);
+    CHECK_THROWS(step::mapped_suffix_array<char, uint32_t>{file});
+}
+
+TEST_CASE("mapped_suffix_tree")
+{
+    using mapped_t = step::mapped_suffix_tree<char, size_t, std::greater<>>;
+    auto file = "mapped_suffix_tree.tmp";
+    auto find_all = [](auto& tree, auto& pattern) {
+        std::vector<size_t> res;
+        tree.find_all(pattern, std::back_inserter(res));
+        std::sort(res.begin(), res.end());
+        return res;
+    };
+    for (auto& str : texts) {
+        auto half = str.begin() + str.size() / 2;
+        ordered_suffix_tree tree{};
+        tree.append(str.begin(), half);
+        for (int i = 0; i < 100; ++i)
+            tree.pop_front();
+        {
+            std::ofstream os{file, std::ios::binary};
+            step::save<std::greater<>>(tree, os);
+        }
+        mapped_t mapped{file};
+        REQUIRE(mapped.size() == tree.size());
+        CHECK(std::string_view(mapped.data(), mapped.size()) ==
+              std::string_view(tree.data(), tree.size()));
+        CHECK(tree_order(mapped) == tree_order(tree));
+        for (size_t pos = 0; pos < tree.size(); pos += tree.size() / 16) {
+            auto pattern = std::string(tree.data() + pos, 4);
+            CHECK(mapped.find(pattern) == tree.find(pattern));
+            CHECK(find_all(mapped, pattern) == find_all(tree, pattern));
+        }
+        CHECK(mapped.find("not found"sv) == mapped.size());
+
+        ordered_suffix_tree resumed{};
+        step::load(mapped, resumed);
+        resumed.append(half, str.end());
+        tree.append(half, str.end());
+        CHECK(tree_order(resumed) == tree_order(tree));
+        resumed.pop_front();
+        tree.pop_front();
+        CHECK(tree_order(resumed) == tree_order(tree));
+    }
+    std::remove(file);
+    CHECK_THROWS(mapped_t{file});
+}
+
+TEST_CASE("fm_index_hello_world")
+{
+    auto str = "how much wood would a woodchuck chuck"sv;
+    step::fm_index idx{step::suffix_array{str}};
+    CHECK(idx.count("wood"sv) == 2);
+    std::vector<size_t> offsets;
+    idx.find_all("ould"sv, std::back_inserter(offsets));
+    CHECK(offsets == std::vector<size_t>{15});
+}
+
+TEST_CASE("fm_index_find_all")
+{
+    std::mt19937 gen{std::random_device{}()};
+    for (size_t len = 0; len < 120; ++len)
+        for (auto alphabet : {"a"sv, "ab"sv, "ACGT"sv}) {
+            std::uniform_int_distribution<size_t> dist{0, alphabet.size() - 1};
+            std::string str;
+            std::generate_n(std::back_inserter(str), len, [&] {
+                return alphabet[dist(gen)];
+            });
+            step::suffix_array<char, uint8_t> arr{str};
+            for (uint8_t sample_rate : {1, 3, 32}) {
+                step::fm_index idx{arr, sample_rate};
+                for (size_t pos = 0; pos <= len; pos += 3)
+                    for (auto pattern : {str.substr(pos, 1),
+                                         str.substr(pos, 4),
+                                         str.substr(pos) + "C",
+                                         ""s}) {
+                        auto expect = arr.find_all(pattern);
+                        std::vector<uint8_t> offsets;
+                        idx.find_all(pattern, std::back_inserter(offsets));
+                        CHECK(idx.count(pattern) == step::size(expect));
+                        CHECK(std::equal(offsets.begin(),
+                                         offsets.end(),
+                                         expect.first,
+                                         expect.second));
+                    }
+            }
+        }
+}
+
+template <class Size, class Algorithm>
+auto array_order(const std::string& str, Algorithm algorithm)
+{
+    step::suffix_array<char, Size> arr{str, algorithm};
+    std::vector<Size> res(arr.size());
+    for (Size i = 0; i < arr.size(); ++i)
+        res[i] = arr.nth_element(i);
+    return res;
+}
+
+TEST_CASE("suffix_array_algorithms")
+{
+    std::mt19937 gen{std::random_device{}()};
+    for (size_t len = 0; len < 120; ++len)
+        for (auto alphabet : {"a"sv, "ab"sv, "abc"sv, "ACGT"sv}) {
+            std::uniform_int_distribution<size_t> dist{0, alphabet.size() - 1};
+            std::string str;
+            std::generate_n(std::back_inserter(str), len, [&] {
+                return alphabet[dist(gen)];
+            });
+            auto expect = array_order<uint8_t>(str, step::prefix_doubling{});
+            CHECK(array_order<uint8_t>(str, step::prefix_doubling{3}) ==
+                  expect);
+            CHECK(array_order<uint8_t>(str, step::radix_doubling{}) ==
+                  expect);
+            CHECK(array_order<uint8_t>(str, step::induced_sorting{}) ==
+                  expect);
+        }
+}
+
+template <class T>
+void check_lcp(const std::basic_string<T>& str)
+{
+    step::suffix_array<T, uint8_t> arr{str};
+    std::vector<uint8_t> expect(arr.size()), plcp(arr.size());
+    for (uint8_t i = 0; i + 1 < arr.size(); ++i) {
+        auto diff = std::mismatch(str.begin() + arr.nth_element(i),
+                                  str.end(),
+                                  str.begin() + arr.nth_element(i + 1),
+                                  str.end());
+        expect[i] = (uint8_t)std::distance(str.begin(), diff.first) -
+                    arr.nth_element(i);
     }
+    arr.permuted_longest_common_prefix_array(plcp.begin());
+    bool same = true;
+    for (uint8_t i = 0; i < arr.size(); ++i)
+        same &= plcp[arr.nth_element(i)] == expect[i];
+    CHECK(same);
+    std::vector<uint8_t> lcp(arr.size());
+    arr.longest_common_prefix_array(lcp.begin());
+    CHECK(lcp == expect);
+}
+
+TEST_CASE("suffix_array_lcp")
+{
+    std::mt19937 gen{std::random_device{}()};
+    for (size_t len = 0; len < 120; ++len)
+        for (auto alphabet : {"a"sv, "ab"sv, "ACGT"sv}) {
+            std::uniform_int_distribution<size_t> dist{0, alphabet.size() - 1};
+            std::string str;
+            std::generate_n(std::back_inserter(str), len, [&] {
+                return alphabet[dist(gen)];
+            });
+            check_lcp(str);
+            check_lcp(std::wstring(str.begin(), str.end()));
+        }
 }
 
 TEST_CASE("suffix_array_benchmark")
@@ -231,6 +753,81 @@ TEST_CASE("suffix_array_benchmark")
         };
 }
 
+TEST_CASE("suffix_array_parallel_benchmark")
+{
+    for (auto& str : texts)
+        BENCHMARK(std::to_string(str.size()) + " chars suffix array (parallel)")
+        {
+            step::suffix_array<char, uint32_t> arr{str,
+                                                   step::prefix_doubling{4}};
+        };
+}
+
+TEST_CASE("suffix_array_radix_doubling_benchmark")
+{
+    for (auto& str : texts)
+        BENCHMARK(std::to_string(str.size()) + " chars suffix array (radix)")
+        {
+            step::suffix_array<char, uint32_t> arr{str,
+                                                   step::radix_doubling{}};
+        };
+}
+
+TEST_CASE("suffix_array_induced_sorting_benchmark")
+{
+    for (auto& str : texts)
+        BENCHMARK(std::to_string(str.size()) + " chars suffix array (SA-IS)")
+        {
+            step::suffix_array<char, uint32_t> arr{str,
+                                                   step::induced_sorting{}};
+        };
+}
+
+TEST_CASE("suffix_array_find_benchmark")
+{
+    auto& str = texts.back();
+    step::suffix_array<char, uint32_t> arr{str, step::induced_sorting{}};
+    std::vector<std::string> patterns;
+    for (size_t pos = 0; pos < str.size(); pos += str.size() / 1000)
+        patterns.push_back(str.substr(pos, 16));
+    BENCHMARK("1000 patterns search")
+    {
+        return std::count_if(patterns.begin(), patterns.end(), [&](auto& p) {
+            return arr.find(p) < arr.size();
+        });
+    };
+    BENCHMARK("1000 patterns batch search")
+    {
+        std::vector<std::pair<size_t, decltype(arr.find_all(""sv))>> res;
+        arr.find_all_batch(
+            patterns.begin(), patterns.end(), std::back_inserter(res));
+        return res.size();
+    };
+    arr.build_lcp_lr();
+    BENCHMARK("1000 patterns search (LCP-LR)")
+    {
+        return std::count_if(patterns.begin(), patterns.end(), [&](auto& p) {
+            return arr.find(p) < arr.size();
+        });
+    };
+}
+
+TEST_CASE("fm_index_find_benchmark")
+{
+    auto& str = texts.back();
+    step::fm_index idx{
+        step::suffix_array<char, uint32_t>{str, step::induced_sorting{}}};
+    std::vector<std::string> patterns;
+    for (size_t pos = 0; pos < str.size(); pos += str.size() / 1000)
+        patterns.push_back(str.substr(pos, 16));
+    BENCHMARK("1000 patterns count (FM-index)")
+    {
+        return std::count_if(patterns.begin(), patterns.end(), [&](auto& p) {
+            return idx.count(p) > 0;
+        });
+    };
+}
+
 TEST_CASE("suffix_tree_benchmark")
 {
     for (auto& str : texts)
@@ -242,4 +839,93 @@ TEST_CASE("suffix_tree_benchmark")
         };
 }
 
+TEST_CASE("suffix_tree_flat_map_benchmark")
+{
+    for (auto& str : texts)
+        BENCHMARK(std::to_string(str.size()) + " chars suffix tree (flat_map)")
+        {
+            step::suffix_tree<char, uint32_t, step::flat_map> tree{};
+            tree.reserve((uint32_t)str.size());
+            std::copy(str.begin(), str.end(), std::back_inserter(tree));
+        };
+}
+
+TEST_CASE("suffix_tree_append_benchmark")
+{
+    for (auto& str : texts)
+        BENCHMARK(std::to_string(str.size()) + " chars suffix tree (append)")
+        {
+            step::suffix_tree<char, uint32_t, step::flat_map> tree{};
+            tree.append(str);
+        };
+}
+
+TEST_CASE("suffix_tree_sliding_window_benchmark")
+{
+    auto& str = texts.back();
+    for (uint32_t window : {1 << 10, 1 << 14})
+        BENCHMARK(std::to_string(window) + " chars sliding window")
+        {
+            step::suffix_tree<char, uint32_t, step::flat_map> tree{};
+            for (char c : str) {
+                tree.push_back(c);
+                if (tree.size() > window)
+                    tree.pop_front();
+            }
+            return tree.size();
+        };
+}
+
+TEST_CASE("suffix_tree_from_suffix_array_benchmark")
+{
+    for (auto& str : texts)
+        BENCHMARK(std::to_string(str.size()) + " chars suffix tree (SA-IS)")
+        {
+            step::suffix_array<char, uint32_t> arr{str,
+                                                   step::induced_sorting{}};
+            step::suffix_tree<char, uint32_t, step::flat_map> tree{arr};
+        };
+}
+
+template <class Key, class T>
+using arena_map_unordered =
+    std::unordered_map<Key,
+                       T,
+                       std::hash<Key>,
+                       std::equal_to<Key>,
+                       step::arena_allocator<std::pair<const Key, T>>>;
+
+TEST_CASE("suffix_tree_arena_benchmark")
+{
+    for (auto& str : texts)
+        BENCHMARK(std::to_string(str.size()) + " chars suffix tree (arena)")
+        {
+            using alloc_t = step::arena_allocator<char>;
+            step::arena mem;
+            step::suffix_tree<char, uint32_t, arena_map_unordered, alloc_t>
+                tree{mem};
+            tree.reserve((uint32_t)str.size());
+            std::copy(str.begin(), str.end(), std::back_inserter(tree));
+        };
+}
+
+TEST_CASE("generalized_suffix_tree_benchmark")
+{
+    auto& str = texts.back();
+    std::vector<std::string_view> lines;
+    for (size_t pos = 0, next; pos < str.size(); pos = next + 1) {
+        next = std::min(str.find('\n', pos), str.size());
+        lines.push_back(std::string_view{str}.substr(pos, next - pos));
+    }
+    BENCHMARK(std::to_string(lines.size()) + " lines generalized suffix tree")
+    {
+        step::generalized_suffix_tree<char, uint32_t, step::flat_map> tree{};
+        tree.reserve(uint32_t(str.size() + 1));
+        for (auto line : lines)
+            tree.push_back(line);
+        tree.build_document_frequency();
+        return tree.document_frequency("return"sv);
+    };
+}
+
 #endif  // STEP_TEST_SUFFIX_HPP